@@ -13,6 +13,129 @@
 #include <ostream>
 #include <fstream>
 #include <stdexcept>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <functional>
+#include <vector>
+#include <unordered_set>
+#include <thread>
+#include <limits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Tipo di default usato da Set per dimensioni e indici.
+ * 
+ * Di default unsigned int; per set oltre i 4 miliardi di elementi
+ * può essere ridefinito prima dell'inclusione, ad esempio
+ * -DGSET_SIZE_TYPE=std::uint64_t (opzione CMake GSET_SIZE_64).
+ * La macro sceglie solo l'argomento di default del parametro Size:
+ * deve avere lo stesso valore in tutte le unità di traduzione di un
+ * programma. Per usare più dimensioni insieme si indica Size esplicitamente.
+ */
+#ifndef GSET_SIZE_TYPE
+#define GSET_SIZE_TYPE unsigned int
+#endif
+
+// Con GSET_HUGE_PAGES (solo Linux) i buffer di almeno GSET_HUGE_PAGE_SIZE byte
+// vengono allineati alla dimensione di una huge page e marcati con
+// madvise(MADV_HUGEPAGE), riducendo i TLB miss nelle scansioni complete.
+#if defined(GSET_HUGE_PAGES) && defined(__linux__)
+#include <cstdlib>
+#include <sys/mman.h>
+#define GSET_USE_HUGE_PAGES 1
+#ifndef GSET_HUGE_PAGE_SIZE
+#define GSET_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+#endif
+#endif
+
+/**
+ * @brief Tag per la costruzione di un Set da elementi già distinti.
+ * 
+ * Indica al costruttore che la sequenza non contiene duplicati
+ * (ad esempio perché è un sottoinsieme di un altro Set),
+ * così che il controllo di unicità possa essere omesso.
+ */
+struct assume_unique_t {};
+static const assume_unique_t assume_unique = assume_unique_t();
+
+namespace gset_detail
+{
+    template<typename S>
+    struct SlotAccess;
+
+    const double DEFAULT_GROWTH_FACTOR = 1.5;   //Fattore di crescita della capacità
+    const double DEFAULT_SHRINK_RATIO = 0.25;   //Occupazione sotto cui la capacità viene ridotta
+    const unsigned MIN_SHRINK_CAPACITY = 16;    //Capacità sotto cui non si riduce mai
+
+    /**
+     * @brief Capacità successiva secondo un fattore di crescita.
+     * 
+     * La crescita è di almeno un elemento e viene limitata
+     * a maxCapacity invece di superare il massimo rappresentabile da Size.
+     * 
+     * @tparam Size Tipo delle dimensioni (senza segno).
+     * @param capacity Capacità corrente.
+     * @param maxCapacity Capacità massima.
+     * @param factor Fattore di crescita (> 1).
+     * @return Size Nuova capacità.
+     * 
+     * @throw std::length_error se capacity ha già raggiunto maxCapacity.
+     */
+    template<typename Size>
+    Size grow_capacity(Size capacity, Size maxCapacity, double factor = DEFAULT_GROWTH_FACTOR)
+    {
+        if(capacity >= maxCapacity)
+            throw std::length_error("Set: capacità massima raggiunta");
+        if(capacity < 2)
+            return maxCapacity < 2 ? maxCapacity : 2;
+
+        double step = static_cast<double>(capacity) * (factor - 1);
+        if(step >= static_cast<double>(maxCapacity - capacity))
+            return maxCapacity;
+        return capacity + std::max<Size>(1, static_cast<Size>(step));
+    }
+
+    /**
+     * @brief Memoria allocata da un elemento oltre a sizeof(T).
+     * 
+     * Di default 0; per i propri tipi è possibile definire un overload
+     * std::size_t heap_usage(const T&) nello stesso namespace di T,
+     * che viene trovato tramite ADL da Set::memory_usage.
+     */
+    template<typename T>
+    std::size_t heap_usage(const T&)
+    {
+        return 0;
+    }
+
+    template<typename C, typename Tr, typename A>
+    std::size_t heap_usage(const std::basic_string<C, Tr, A>& s)
+    {
+        // Le stringhe corte sono memorizzate nell'oggetto stesso (small string optimization)
+        const char* data = reinterpret_cast<const char*>(s.data());
+        const char* self = reinterpret_cast<const char*>(&s);
+        std::less<const char*> before;
+        if(!before(data, self) && before(data, self + sizeof(s)))
+            return 0;
+        return (s.capacity() + 1) * sizeof(C);
+    }
+
+    template<typename U, typename A>
+    std::size_t heap_usage(const std::vector<U, A>& v)
+    {
+        std::size_t bytes = v.capacity() * sizeof(U);
+        for(std::size_t i = 0; i < v.size(); i++)
+        {
+            bytes += heap_usage(v[i]);
+        }
+        return bytes;
+    }
+}
 
 /**
  * @brief Classe Set generica.
@@ -25,38 +148,44 @@
  * @tparam T Tipo degli elementi nel set
  * (deve essere necessariamente dotato di costruttore di default).
  * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Size Tipo senza segno per dimensioni e indici (default GSET_SIZE_TYPE).
  */
-template<typename T, typename Equal>
+template<typename T, typename Equal, typename Size = GSET_SIZE_TYPE>
 class Set
 {
+    static_assert(std::is_unsigned<Size>::value, "Size deve essere un tipo senza segno");
+
 public:
-    typedef unsigned int size_type;
+    typedef Size size_type;
+    typedef T value_type;
+    typedef Equal key_equal;
 
     /**
      * @brief Costruttore di default.
      * 
      * @post mData = nullptr, mSize = 0, mCapacity = 0.
      */
-    Set() : mData(nullptr), mSize(0), mCapacity(0){}
+    Set() : mData(nullptr), mDead(nullptr), mSize(0), mDeadCount(0), mCapacity(0), mCompactRatio(0),
+            mGrowthFactor(gset_detail::DEFAULT_GROWTH_FACTOR), mShrinkRatio(gset_detail::DEFAULT_SHRINK_RATIO) {}
 
     /**
      * @brief Costruttore di copia.
      *
+     * Alloca esattamente lo spazio per gli elementi presenti in other.
+     *
      * @param other Altro set da copiare.
      * 
      * @throw Eccezione di allocazione
      */
-    Set(const Set& other) : mData(nullptr), mEq(other.mEq), mSize(0), mCapacity(0)
+    Set(const Set& other) : mData(nullptr), mDead(nullptr), mEq(other.mEq), mSize(0), mDeadCount(0), mCapacity(0),
+                            mCompactRatio(other.mCompactRatio), mGrowthFactor(other.mGrowthFactor),
+                            mShrinkRatio(other.mShrinkRatio)
     {
         try
         {
-            resize(other.mCapacity);
-            mSize = other.mSize;
-
-            for(size_type i = 0; i < mSize; i++)
-            {
-                mData[i] = other[i];
-            }
+            if(other.mSize > 0)
+                resize(other.mSize);
+            copyLive(other);
         }
         catch(...)
         {
@@ -65,6 +194,21 @@ public:
         }
     }
 
+    /**
+     * @brief Costruttore di spostamento.
+     *
+     * Acquisisce la memoria di other senza copiarne gli elementi.
+     *
+     * @param other Set da spostare.
+     * @post other è vuoto.
+     */
+    Set(Set&& other) noexcept : mData(other.mData), mDead(other.mDead), mEq(other.mEq), mSize(other.mSize),
+                       mDeadCount(other.mDeadCount), mCapacity(other.mCapacity), mCompactRatio(other.mCompactRatio),
+                       mGrowthFactor(other.mGrowthFactor), mShrinkRatio(other.mShrinkRatio)
+    {
+        other.release();
+    }
+
     /**
      * @brief Costruttore da coppia generica di iteratori.
      * 
@@ -75,7 +219,8 @@ public:
      * @throw Errore di allocazione
      */
     template <typename Iter>
-    Set(Iter begin, Iter end) : mData(nullptr), mSize(0), mCapacity(0)
+    Set(Iter begin, Iter end) : mData(nullptr), mDead(nullptr), mSize(0), mDeadCount(0), mCapacity(0), mCompactRatio(0),
+                                mGrowthFactor(gset_detail::DEFAULT_GROWTH_FACTOR), mShrinkRatio(gset_detail::DEFAULT_SHRINK_RATIO)
     {
         Iter curr = begin;
         try 
@@ -92,6 +237,38 @@ public:
         }
     }
 
+    /**
+     * @brief Costruttore da coppia di iteratori su elementi già distinti.
+     * 
+     * Copia gli elementi senza verificarne l'unicità, che è responsabilità
+     * del chiamante. Se gli iteratori sono almeno forward la memoria
+     * viene allocata una sola volta.
+     * 
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     * 
+     * @throw Errore di allocazione
+     */
+    template <typename Iter>
+    Set(assume_unique_t, Iter begin, Iter end) : mData(nullptr), mDead(nullptr), mSize(0), mDeadCount(0), mCapacity(0), mCompactRatio(0),
+                                                 mGrowthFactor(gset_detail::DEFAULT_GROWTH_FACTOR), mShrinkRatio(gset_detail::DEFAULT_SHRINK_RATIO)
+    {
+        try
+        {
+            reserveFor(begin, end, typename std::iterator_traits<Iter>::iterator_category());
+            for(; begin != end; ++begin)
+            {
+                appendUnique(static_cast<T>(*begin));
+            }
+        }
+        catch(...)
+        {
+            empty();
+            throw;
+        }
+    }
+
     /**
      * @brief Distruttore.
      */
@@ -103,6 +280,10 @@ public:
     /**
      * @brief Operatore di assegnamento.
      * 
+     * Se la capacità corrente è sufficiente il buffer esistente
+     * viene riutilizzato, altrimenti viene allocato esattamente
+     * lo spazio per gli elementi presenti in other.
+     * 
      * @param other Altro set da assegnare.
      * @return Set& Riferimento al set corrente.
      * 
@@ -115,13 +296,19 @@ public:
 
         try
         {
-            resize(other.mCapacity);
-            mSize = other.mSize;
-
-            for(size_type i = 0; i < mSize; i++)
+            mSize = 0;
+            mDeadCount = 0;
+            if(mDead != nullptr)
             {
-                mData[i] = other[i];
+                delete[] mDead;
+                mDead = nullptr;
             }
+            if(other.mSize > mCapacity)
+                resize(other.mSize);
+            copyLive(other);
+            mCompactRatio = other.mCompactRatio;
+            mGrowthFactor = other.mGrowthFactor;
+            mShrinkRatio = other.mShrinkRatio;
         }
         catch(...)
         {
@@ -132,14 +319,42 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Operatore di assegnamento per spostamento.
+     *
+     * @param other Set da spostare.
+     * @return Set& Riferimento al set corrente.
+     * @post other è vuoto.
+     */
+    Set& operator=(Set&& other) noexcept
+    {
+        if(this == &other)
+            return *this;
+
+        empty();
+        mData = other.mData;
+        mDead = other.mDead;
+        mEq = other.mEq;
+        mSize = other.mSize;
+        mDeadCount = other.mDeadCount;
+        mCapacity = other.mCapacity;
+        mCompactRatio = other.mCompactRatio;
+        mGrowthFactor = other.mGrowthFactor;
+        mShrinkRatio = other.mShrinkRatio;
+        other.release();
+
+        return *this;
+    }
+
     /**
      * @brief Aggiunge un elemento al set.
      * 
      * Aggiunge un elemento al set, verificando 
      * prima che questo non sia già presente.
      * Nel caso in cui la memoria preallocata non sia sufficiente
-     * per ospitare il nuovo elemento viene incrementata la
-     * dimensione della struttura sottostante.
+     * per ospitare il nuovo elemento vengono prima recuperati
+     * gli slot rimossi in modo differito (se presenti), altrimenti
+     * viene incrementata la dimensione della struttura sottostante.
      * 
      * @param value Valore da aggiungere.
      * @return true Se l'elemento è stato aggiunto con successo.
@@ -151,49 +366,278 @@ public:
         if(contains(value))
             return false; //Elemento già presente
 
+        appendUnique(value);
+        return true;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set.
+     * 
+     * Con la rimozione differita attiva (vedi setCompactRatio)
+     * lo slot dell'elemento viene solo marcato come rimosso,
+     * altrimenti gli elementi successivi vengono spostati a sinistra.
+     * 
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(const T& value)
+    {
+        return removeSlot(findSlot(value));
+    }
+
+    /**
+     * @brief Rimuove l'elemento equivalente a una chiave di tipo diverso da T.
+     * 
+     * Disponibile solo se Equal dichiara il tipo is_transparent
+     * e può confrontare un T con un K (chiamata mEq(elemento, key)).
+     * Evita la costruzione di un T temporaneo per la ricerca.
+     * 
+     * @tparam K Tipo della chiave.
+     * @param key Chiave da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se nessun elemento è equivalente alla chiave.
+     */
+    template<typename K, typename E = Equal, typename = typename E::is_transparent>
+    bool remove(const K& key)
+    {
+        return removeSlot(findSlot(key));
+    }
+
+    /**
+     * @brief Imposta la soglia di compattazione della rimozione differita.
+     * 
+     * Con ratio > 0 remove marca lo slot come rimosso (tombstone) senza
+     * spostare gli altri elementi; gli slot rimossi vengono recuperati
+     * in un unico passaggio quando la loro frazione sugli slot occupati
+     * raggiunge ratio, oppure con compact().
+     * Con ratio <= 0 (default) la rimozione è immediata e gli eventuali
+     * slot rimossi vengono compattati subito.
+     * 
+     * @param ratio Frazione di slot rimossi che provoca la compattazione.
+     */
+    void setCompactRatio(double ratio)
+    {
+        mCompactRatio = ratio > 0 ? ratio : 0;
+        if(mCompactRatio == 0)
+            compact();
+    }
+
+    double getCompactRatio() const { return mCompactRatio; }
+
+    /**
+     * @brief Imposta il fattore di crescita della capacità.
+     * 
+     * Quando il buffer è pieno la capacità viene moltiplicata per factor
+     * (con una crescita di almeno un elemento). Il default è 1.5.
+     * 
+     * @param factor Fattore di crescita.
+     * 
+     * @throw std::invalid_argument se factor <= 1 o se
+     * factor * soglia di riduzione >= 1 (vedi setShrinkRatio).
+     */
+    void setGrowthFactor(double factor)
+    {
+        if(!(factor > 1))
+            throw std::invalid_argument("Il fattore di crescita deve essere maggiore di 1");
+        if(mShrinkRatio * factor >= 1)
+            throw std::invalid_argument("La soglia di riduzione deve essere minore di 1 / fattore di crescita");
+        mGrowthFactor = factor;
+    }
+
+    double getGrowthFactor() const { return mGrowthFactor; }
+
+    /**
+     * @brief Imposta la soglia di riduzione automatica della capacità.
+     * 
+     * Quando dopo una rimozione gli elementi presenti scendono sotto
+     * ratio * capacità, il buffer viene riallocato con capacità
+     * getSize() * fattore di crescita. Con ratio <= 0 la capacità
+     * non viene mai ridotta automaticamente. Il default è 0.25;
+     * i set con capacità fino a 16 elementi non vengono ridotti.
+     * 
+     * @param ratio Frazione di occupazione che provoca la riduzione.
+     * 
+     * @throw std::invalid_argument se ratio * fattore di crescita >= 1:
+     * il buffer ridotto sarebbe di nuovo sotto la soglia.
+     */
+    void setShrinkRatio(double ratio)
+    {
+        if(ratio > 0 && ratio * mGrowthFactor >= 1)
+            throw std::invalid_argument("La soglia di riduzione deve essere minore di 1 / fattore di crescita");
+        mShrinkRatio = ratio > 0 ? ratio : 0;
+    }
+
+    double getShrinkRatio() const { return mShrinkRatio; }
+
+    /**
+     * @brief Prealloca la memoria per almeno n elementi.
+     * 
+     * Con n minore o uguale alla capacità corrente non ha effetto.
+     * Le rimozioni successive possono ridurre di nuovo la capacità
+     * (vedi setShrinkRatio).
+     * 
+     * @param n Numero di elementi.
+     * 
+     * @throw std::length_error se n supera la capacità massima.
+     * @throw Eccezione di allocazione
+     */
+    void reserve(size_type n)
+    {
+        if(n <= mCapacity)
+            return;
+        if(n > maxCapacity())
+            throw std::length_error("Set: capacità massima raggiunta");
+
+        compact();
+        resize(n);
+    }
+
+    /**
+     * @brief Riduce la capacità al numero di elementi presenti.
+     * 
+     * Compatta gli slot rimossi in modo differito e rialloca
+     * il buffer con la dimensione esatta (lo libera se il set è vuoto).
+     * 
+     * @throw Eccezione di allocazione
+     */
+    void shrink_to_fit()
+    {
+        compact();
+        if(mSize == mCapacity)
+            return;
+
+        if(mSize == 0)
+        {
+            empty();
+            return;
+        }
+        resize(mSize);
+    }
+
+    /**
+     * @brief Memoria occupata dal set, in byte.
+     * 
+     * Comprende la struttura stessa, il buffer degli elementi, i marcatori
+     * della rimozione differita e la memoria allocata dagli elementi
+     * in tutti gli slot del buffer (vedi gset_detail::heap_usage).
+     * 
+     * @return std::size_t Byte occupati.
+     */
+    std::size_t memory_usage() const
+    {
+        using gset_detail::heap_usage;
+
+        std::size_t bytes = sizeof(*this) + static_cast<std::size_t>(mCapacity) * sizeof(T);
+        if(mDead != nullptr)
+            bytes += static_cast<std::size_t>(mCapacity) * sizeof(bool);
+        for(size_type i = 0; i < mCapacity; i++)
+        {
+            bytes += heap_usage(mData[i]);
+        }
+
+        return bytes;
+    }
+
+    /**
+     * @brief Mantiene solo gli elementi che soddisfano un predicato.
+     * 
+     * Gli elementi vengono compattati nel buffer esistente in un
+     * unico passaggio, preservandone l'ordine. Se l'occupazione scende
+     * sotto la soglia di setShrinkRatio il buffer viene riallocato
+     * con una capacità minore; se la riallocazione fallisce il buffer
+     * corrente viene mantenuto.
+     * 
+     * Se pred solleva un'eccezione gli elementi già scartati restano
+     * rimossi, mentre l'elemento corrente e i successivi vengono
+     * mantenuti: il set resta valido e l'eccezione viene rilanciata.
+     * 
+     * @tparam Pred Predicato di filtro.
+     * @param pred Predicato di filtro.
+     * @return size_type Numero di elementi rimossi.
+     * 
+     * @throw L'eccezione sollevata da pred.
+     */
+    template<typename Pred>
+    size_type retain_if(Pred pred)
+    {
+        size_type used = usedSlots();
+        size_type j = 0;
+        size_type i = 0;
         try
         {
-            if(mData == nullptr)
-            {
-                resize(2);
-            }
-            if(mSize == mCapacity)
+            for(; i < used; i++)
             {
-                resize(mCapacity + mCapacity / 2);
+                if(isLive(i) && pred(static_cast<const T&>(mData[i])))
+                {
+                    if(i != j)
+                        mData[j] = std::move(mData[i]);
+                    j++;
+                }
             }
-        
-            mData[mSize] = value;
-            mSize++;
         }
         catch(...)
         {
-            empty();
+            // Predicato fallito: gli slot non ancora valutati vengono mantenuti
+            for(; i < used; i++)
+            {
+                if(isLive(i))
+                {
+                    if(i != j)
+                        mData[j] = std::move(mData[i]);
+                    j++;
+                }
+            }
+            if(mDead != nullptr)
+            {
+                delete[] mDead;
+                mDead = nullptr;
+            }
+            mSize = j;
+            mDeadCount = 0;
             throw;
         }
-        
-        return true;
+
+        if(mDead != nullptr)
+        {
+            delete[] mDead;
+            mDead = nullptr;
+        }
+
+        size_type removed = mSize - j;
+        mSize = j;
+        mDeadCount = 0;
+        shrinkIfSparse();
+        return removed;
     }
 
     /**
-     * @brief Rimuove un elemento dal set.
+     * @brief Compatta gli slot rimossi in modo differito.
      * 
-     * @param value Valore da rimuovere.
-     * @return true Se l'elemento è stato rimosso con successo.
-     * @return false Se l'elemento non è presente nel set.
+     * Sposta gli elementi presenti verso l'inizio dell'array
+     * in un unico passaggio, preservandone l'ordine.
+     * 
+     * @post Nessuno slot rimosso.
      */
-    bool remove(const T& value)
+    void compact()
     {
-        for(size_type i = 0; i < mSize; i++)
+        if(mDeadCount == 0)
+            return;
+
+        size_type used = usedSlots();
+        size_type j = 0;
+        for(size_type i = 0; i < used; i++)
         {
-            if(mEq(mData[i], value))
+            if(!mDead[i])
             {
-                shiftLeft(i);
-                mSize--;
-                return true;
+                if(i != j)
+                    mData[j] = std::move(mData[i]);
+                j++;
             }
+            mDead[i] = false;
         }
 
-        return false; //Elemento assente
+        mDeadCount = 0;
     }
 
     /**
@@ -208,13 +652,24 @@ public:
      */
     bool contains(const T& value) const
     {
-        for(size_type i = 0; i < mSize; i++)
-        {
-            if(mEq(mData[i], value))
-                return true;
-        }
+        return findSlot(value) != usedSlots();
+    }
 
-        return false;
+    /**
+     * @brief Verifica se un elemento equivalente alla chiave è presente nel set.
+     * 
+     * Disponibile solo se Equal dichiara il tipo is_transparent
+     * (vedi remove(const K&)).
+     * 
+     * @tparam K Tipo della chiave.
+     * @param key Chiave da cercare.
+     * @return true se un elemento equivalente è presente.
+     * @return false altrimenti.
+     */
+    template<typename K, typename E = Equal, typename = typename E::is_transparent>
+    bool contains(const K& key) const
+    {
+        return findSlot(key) != usedSlots();
     }
 
     /**
@@ -226,17 +681,27 @@ public:
     {
         if(mData != nullptr)
         {
-            delete[] mData;
+            freeData(mData, mCapacity);
             mData = nullptr;
         }
+        if(mDead != nullptr)
+        {
+            delete[] mDead;
+            mDead = nullptr;
+        }
         
         mSize = 0;
+        mDeadCount = 0;
         mCapacity = 0;
     }
 
     /**
      * @brief Operatore di accesso agli elementi del set.
      * 
+     * In presenza di slot rimossi in modo differito l'accesso
+     * richiede una scansione lineare: chiamando compact() prima
+     * degli accessi per indice ogni accesso torna in tempo costante.
+     * 
      * @param index Indice dell'elemento.
      * @return T elemento.
      * 
@@ -246,7 +711,17 @@ public:
     {
         if(index < 0 || index >= mSize)
             throw std::out_of_range("index out of bounds"); //index out of bounds
-        return mData[index];
+
+        if(mDeadCount == 0)
+            return mData[index];
+
+        size_type i = 0;
+        for(;; i++)
+        {
+            if(isLive(i) && index-- == 0)
+                break;
+        }
+        return mData[i];
     }
 
     /**
@@ -263,9 +738,9 @@ public:
         if(mSize != other.mSize)
             return false;
 
-        for(size_type i = 0; i < mSize; i++)
+        for(const_iterator i = other.begin(); i != other.end(); ++i)
         {
-            if(!contains(other[i]))
+            if(!contains(*i))
                 return false;
         }
 
@@ -282,9 +757,9 @@ public:
     friend std::ostream& operator<<(std::ostream& out, const Set& set)
     {
         out << set.mSize;
-        for(typename Set::size_type i = 0; i < set.mSize; i++)
+        for(const_iterator i = set.begin(); i != set.end(); ++i)
         {
-            out << " (" << set[i] << ")";
+            out << " (" << *i << ")";
         }
 
         return out;
@@ -305,13 +780,15 @@ public:
 		typedef const T&                  reference;
 
 	
-		const_iterator() : n(nullptr) {}
+		const_iterator() : n(nullptr), e(nullptr), d(nullptr) {}
 		
-		const_iterator(const const_iterator &other) : n(other.n) {}
+		const_iterator(const const_iterator &other) : n(other.n), e(other.e), d(other.d) {}
 
 		const_iterator& operator=(const const_iterator &other)
         {
             n = other.n;
+            e = other.e;
+            d = other.d;
 			return *this;
 		}
 
@@ -333,7 +810,7 @@ public:
 		const_iterator operator++(int) 
         {
 			const_iterator tmp(*this);
-            n++;
+            ++*this;
             return tmp;
 		}
 
@@ -341,6 +818,11 @@ public:
 		const_iterator& operator++()
         {
 			n++;
+            if(d != nullptr)
+            {
+                d++;
+                skipDead();
+            }
             return *this;
 		}
 
@@ -359,13 +841,29 @@ public:
 	private:
 		//Dati membro
         const T* n;
+        const T* e;     //Fine degli slot occupati
+        const bool* d;  //Marcatore di rimozione di n (nullptr se non ci sono slot rimossi)
 
 		// La classe container deve essere messa friend dell'iteratore per poter
 		// usare il costruttore di inizializzazione.
 		friend class Set;
 
 		// Costruttore privato di inizializzazione usato dalla classe container
-		const_iterator(const T* nn) : n(nn) { }
+		const_iterator(const T* nn, const T* ee, const bool* dd) : n(nn), e(ee), d(dd)
+        {
+            if(d != nullptr)
+                skipDead();
+        }
+
+        // Salta gli slot rimossi in modo differito
+        void skipDead()
+        {
+            while(n != e && *d)
+            {
+                n++;
+                d++;
+            }
+        }
 		
 	}; // classe const_iterator
 	
@@ -376,7 +874,7 @@ public:
      */
 	const_iterator begin() const 
     {
-		return const_iterator(mData);
+		return const_iterator(mData, mData + usedSlots(), mDeadCount > 0 ? mDead : nullptr);
 	}
 	
 	/**
@@ -386,75 +884,580 @@ public:
      */
 	const_iterator end() const
     {
-		return const_iterator(mData + mSize);
+		return const_iterator(mData + usedSlots(), mData + usedSlots(), nullptr);
 	}
 
-private:
     /**
-     * @brief Ridimensiona la capacità del set.
+     * @brief Cerca un elemento nel set.
      * 
-     * @param newSize Nuova dimensione del set.
+     * @param value Valore da cercare.
+     * @return const_iterator Iteratore all'elemento, end() se assente.
      */
-    void resize(size_type newSize)
+    const_iterator find(const T& value) const
     {
-        T* tmp = new T[newSize];
-        
-        for(size_type i = 0; i < mSize; i++)
-        {
-            tmp[i] = mData[i];
-        }
-
-        if(mData != nullptr)
-            delete[] mData;
-        mCapacity = newSize;
-        mData = tmp;
+        return iteratorAt(findSlot(value));
     }
 
     /**
-     * @brief Sposta gli elementi a sinistra a partire dall'indice specificato.
+     * @brief Cerca l'elemento equivalente a una chiave di tipo diverso da T.
      * 
-     * @param index Indice da cui iniziare lo spostamento.
+     * Disponibile solo se Equal dichiara il tipo is_transparent
+     * (vedi remove(const K&)).
+     * 
+     * @tparam K Tipo della chiave.
+     * @param key Chiave da cercare.
+     * @return const_iterator Iteratore all'elemento, end() se assente.
      */
-    void shiftLeft(size_type index)
+    template<typename K, typename E = Equal, typename = typename E::is_transparent>
+    const_iterator find(const K& key) const
     {
-        for(size_type i = index; i < mSize - 1; i++)
-        {
-            mData[i] = mData[i + 1];
-        }
+        return iteratorAt(findSlot(key));
     }
 
 private:
-    T* mData;               //Puntatore ai dati
-    Equal mEq;              //Funtore per confronto elementi
-    size_type mSize;        //Numero di elementi presenti
-    size_type mCapacity;    //Numero di elementi inseribili
-};
+    // Selezione a tempo di compilazione delle copie tramite memcpy/memmove
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> trivially_copyable;
 
+    /**
+     * @brief Copia n elementi tra buffer distinti.
+     */
+    static void copyElements(T* dst, const T* src, size_type n, std::true_type)
+    {
+        if(n > 0)
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    }
 
-/**
- * @brief Filtra gli elementi di un set in base a un predicato.
- * 
- * Funzione GLOBALE che ritorna un set contente 
- * gli elementi di set che soddisfano il predicato pred.
+    static void copyElements(T* dst, const T* src, size_type n, std::false_type)
+    {
+        std::copy(src, src + n, dst);
+    }
+
+    /**
+     * @brief Sposta n elementi verso indirizzi minori o in un altro buffer.
+     */
+    static void moveElements(T* dst, T* src, size_type n, std::true_type)
+    {
+        if(n > 0)
+            std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    }
+
+    static void moveElements(T* dst, T* src, size_type n, std::false_type)
+    {
+        std::move(src, src + n, dst);
+    }
+
+    /**
+     * @brief Ridimensiona la capacità del set.
+     * 
+     * Gli elementi vengono copiati con memcpy se T è trivially copyable,
+     * altrimenti spostati con std::move.
+     * 
+     * @pre Nessuno slot rimosso in modo differito.
+     * 
+     * @param newSize Nuova dimensione del set.
+     */
+    void resize(size_type newSize)
+    {
+        T* tmp = allocateData(newSize);
+        
+        try
+        {
+            moveElements(tmp, mData, mSize, trivially_copyable());
+        }
+        catch(...)
+        {
+            freeData(tmp, newSize);
+            throw;
+        }
+
+        if(mData != nullptr)
+            freeData(mData, mCapacity);
+        if(mDead != nullptr)
+        {
+            delete[] mDead;
+            mDead = nullptr;
+        }
+        mCapacity = newSize;
+        mData = tmp;
+    }
+
+    /**
+     * @brief Sposta gli elementi a sinistra a partire dall'indice specificato.
+     * 
+     * @param index Indice da cui iniziare lo spostamento.
+     */
+    void shiftLeft(size_type index)
+    {
+        moveElements(mData + index, mData + index + 1, mSize - index - 1, trivially_copyable());
+    }
+
+    // Capacità successiva secondo il fattore di crescita
+    size_type grownCapacity() const
+    {
+        return gset_detail::grow_capacity(mCapacity, maxCapacity(), mGrowthFactor);
+    }
+
+    // Massimo numero di elementi rappresentabile da size_type e allocabile
+    static size_type maxCapacity()
+    {
+        const std::size_t bytes = std::numeric_limits<std::size_t>::max() / sizeof(T);
+        const size_type slots = std::numeric_limits<size_type>::max();
+        return bytes < slots ? static_cast<size_type>(bytes) : slots;
+    }
+
+    // Abbandona la memoria, ceduta a un altro set
+    void release() noexcept
+    {
+        mData = nullptr;
+        mDead = nullptr;
+        mSize = 0;
+        mDeadCount = 0;
+        mCapacity = 0;
+    }
+
+    /**
+     * @brief Alloca un buffer di n elementi costruiti di default.
+     * 
+     * Con GSET_HUGE_PAGES i buffer grandi sono allineati
+     * alle huge page e marcati con madvise(MADV_HUGEPAGE).
+     * 
+     * @throw std::bad_alloc o l'eccezione del costruttore di T.
+     */
+    static T* allocateData(size_type n)
+    {
+#ifdef GSET_USE_HUGE_PAGES
+        if(usesHugePages(n))
+        {
+            std::size_t bytes = hugePageBytes(n);
+            void* mem = nullptr;
+            if(::posix_memalign(&mem, GSET_HUGE_PAGE_SIZE, bytes) != 0)
+                throw std::bad_alloc();
+            ::madvise(mem, bytes, MADV_HUGEPAGE); //Solo un suggerimento: un errore non è fatale
+
+            T* data = static_cast<T*>(mem);
+            size_type i = 0;
+            try
+            {
+                for(; i < n; i++)
+                {
+                    new (data + i) T();
+                }
+            }
+            catch(...)
+            {
+                destroyData(data, i);
+                std::free(mem);
+                throw;
+            }
+            return data;
+        }
+#endif
+        return new T[n];
+    }
+
+    // Libera un buffer ottenuto da allocateData(n)
+    static void freeData(T* data, size_type n)
+    {
+#ifdef GSET_USE_HUGE_PAGES
+        if(usesHugePages(n))
+        {
+            destroyData(data, n);
+            std::free(data);
+            return;
+        }
+#else
+        (void)n;
+#endif
+        delete[] data;
+    }
+
+#ifdef GSET_USE_HUGE_PAGES
+    static bool usesHugePages(size_type n)
+    {
+        return static_cast<std::size_t>(n) * sizeof(T) >= GSET_HUGE_PAGE_SIZE;
+    }
+
+    // Dimensione arrotondata a un multiplo della huge page
+    static std::size_t hugePageBytes(size_type n)
+    {
+        std::size_t bytes = static_cast<std::size_t>(n) * sizeof(T);
+        return (bytes + GSET_HUGE_PAGE_SIZE - 1) / GSET_HUGE_PAGE_SIZE * GSET_HUGE_PAGE_SIZE;
+    }
+
+    static void destroyData(T* data, size_type n)
+    {
+        for(size_type i = 0; i < n; i++)
+        {
+            data[i].~T();
+        }
+    }
+#endif
+
+    /**
+     * @brief Accoda un elemento senza verificarne l'unicità.
+     * 
+     * Nel caso in cui la memoria preallocata non sia sufficiente
+     * vengono prima recuperati gli slot rimossi in modo differito
+     * (se presenti), altrimenti viene incrementata la dimensione
+     * della struttura sottostante.
+     * 
+     * @param value Valore da accodare (non presente nel set).
+     * 
+     * @throw Eccezione di allocazione
+     */
+    void appendUnique(const T& value)
+    {
+        try
+        {
+            if(usedSlots() == mCapacity)
+            {
+                if(mDeadCount > 0)
+                    compact();
+                else
+                    resize(grownCapacity());
+            }
+        
+            mData[usedSlots()] = value;
+            mSize++;
+        }
+        catch(const std::length_error&)
+        {
+            throw; //Capacità massima raggiunta: il set resta invariato
+        }
+        catch(...)
+        {
+            empty();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Prealloca la memoria per una sequenza di lunghezza nota.
+     */
+    template <typename Iter>
+    void reserveFor(Iter begin, Iter end, std::forward_iterator_tag)
+    {
+        typename std::iterator_traits<Iter>::difference_type distance = std::distance(begin, end);
+        if(static_cast<unsigned long long>(distance) > maxCapacity())
+            throw std::length_error("Set: capacità massima raggiunta");
+
+        size_type count = static_cast<size_type>(distance);
+        if(count > mCapacity)
+            resize(count);
+    }
+
+    // Con iteratori di input la lunghezza non è nota a priori
+    template <typename Iter>
+    void reserveFor(Iter, Iter, std::input_iterator_tag) {}
+
+    /**
+     * @brief Copia gli elementi presenti di un altro set.
+     * 
+     * @pre Capacità sufficiente e nessuno slot occupato.
+     * 
+     * @param other Set da cui copiare.
+     */
+    void copyLive(const Set& other)
+    {
+        if(other.mDeadCount == 0)
+        {
+            copyElements(mData, other.mData, other.mSize, trivially_copyable());
+            mSize = other.mSize;
+            return;
+        }
+
+        for(const_iterator i = other.begin(); i != other.end(); ++i)
+        {
+            mData[mSize] = *i;
+            mSize++;
+        }
+    }
+
+    /**
+     * @brief Marca uno slot come rimosso e compatta se necessario.
+     * 
+     * @param index Indice dello slot da marcare.
+     * 
+     * @throw Eccezione di allocazione
+     */
+    void markDead(size_type index)
+    {
+        if(mDead == nullptr)
+            mDead = new bool[mCapacity]();
+
+        mDead[index] = true;
+        mDeadCount++;
+        mSize--;
+
+        if(mDeadCount >= mCompactRatio * usedSlots())
+        {
+            compact();
+            shrinkIfSparse();
+        }
+    }
+
+    // Numero di slot occupati, inclusi quelli rimossi in modo differito
+    size_type usedSlots() const { return mSize + mDeadCount; }
+
+    // Verifica se lo slot index contiene un elemento presente
+    bool isLive(size_type index) const { return mDeadCount == 0 || !mDead[index]; }
+
+    /**
+     * @brief Indice dello slot vivo equivalente a key.
+     * 
+     * @return size_type Indice dello slot, usedSlots() se assente.
+     */
+    template<typename K>
+    size_type findSlot(const K& key) const
+    {
+        for(size_type i = 0; i < usedSlots(); i++)
+        {
+            if(isLive(i) && mEq(mData[i], key))
+                return i;
+        }
+
+        return usedSlots();
+    }
+
+    /**
+     * @brief Rimuove l'elemento nello slot index (usedSlots() = nessuno).
+     */
+    bool removeSlot(size_type index)
+    {
+        if(index == usedSlots())
+            return false; //Elemento assente
+
+        if(mCompactRatio > 0)
+        {
+            markDead(index);
+        }
+        else
+        {
+            shiftLeft(index);
+            mSize--;
+            shrinkIfSparse();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Riduce la capacità se l'occupazione è scesa sotto mShrinkRatio.
+     * 
+     * La nuova capacità è mSize * mGrowthFactor: l'occupazione risale
+     * ben sopra la soglia, così che add e remove alternate vicino
+     * alla soglia non provochino ridimensionamenti continui.
+     * La riduzione è facoltativa: se l'allocazione o lo spostamento
+     * degli elementi sollevano un'eccezione il buffer corrente viene mantenuto.
+     * 
+     * @pre Nessuno slot rimosso in modo differito.
+     */
+    void shrinkIfSparse()
+    {
+        if(mShrinkRatio <= 0 || mCapacity <= gset_detail::MIN_SHRINK_CAPACITY ||
+           static_cast<double>(mSize) >= mShrinkRatio * static_cast<double>(mCapacity))
+            return;
+
+        double target = static_cast<double>(mSize) * mGrowthFactor;
+        size_type newCapacity = std::max<size_type>(gset_detail::MIN_SHRINK_CAPACITY, static_cast<size_type>(target));
+        if(newCapacity >= mCapacity)
+            return;
+
+        try
+        {
+            resize(newCapacity);
+        }
+        catch(...)
+        {
+        }
+    }
+
+    // Iteratore allo slot index (vivo o usedSlots())
+    const_iterator iteratorAt(size_type index) const
+    {
+        return const_iterator(mData + index, mData + usedSlots(), mDeadCount > 0 ? mDead + index : nullptr);
+    }
+
+    // Accesso diretto agli slot per gli algoritmi paralleli
+    template<typename S>
+    friend struct gset_detail::SlotAccess;
+
+private:
+    T* mData;               //Puntatore ai dati
+    bool* mDead;            //Marcatori degli slot rimossi in modo differito
+    Equal mEq;              //Funtore per confronto elementi
+    size_type mSize;        //Numero di elementi presenti
+    size_type mDeadCount;   //Numero di slot rimossi in attesa di compattazione
+    size_type mCapacity;    //Numero di elementi inseribili
+    double mCompactRatio;   //Soglia di compattazione (0 = rimozione immediata)
+    double mGrowthFactor;   //Fattore di crescita della capacità
+    double mShrinkRatio;    //Occupazione sotto cui la capacità viene ridotta (0 = mai)
+};
+
+
+/**
+ * @brief Vista filtrata di un set.
+ * 
+ * Vista non proprietaria sugli elementi di un set che soddisfano
+ * un predicato: non alloca memoria e valuta il predicato durante
+ * l'iterazione. Il set deve restare valido e non essere modificato
+ * finché la vista è in uso.
  * 
  * @tparam T Tipo degli elementi nel set.
  * @tparam Equal Funtore per il confronto di uguaglianza.
  * @tparam Pred Predicato per il filtraggio.
- * @param set Set di input.
- * @param pred Predicato di filtro.
- * @return Set<T, Equal> Set filtrato.
+ * @tparam Size Tipo delle dimensioni del set.
  */
-template<typename T, typename Equal, typename Pred>
-Set<T, Equal> filter_out(const Set<T, Equal>& set, Pred pred)
+template<typename T, typename Equal, typename Pred, typename Size = GSET_SIZE_TYPE>
+class FilterView
 {
-    Set<T, Equal> res;
-    for(typename Set<T, Equal>::size_type i = 0; i < set.getSize(); i++)
+public:
+    typedef typename Set<T, Equal, Size>::size_type size_type;
+
+    FilterView(const Set<T, Equal, Size>& set, Pred pred) : mSet(&set), mPred(pred) {}
+
+    /**
+     * @brief Iteratore sugli elementi che soddisfano il predicato.
+     * 
+     * Dichiarato come input iterator così che la costruzione di un Set
+     * dalla vista non valuti il predicato due volte per preallocare.
+     */
+    class const_iterator {
+	public:
+		typedef std::input_iterator_tag   iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef const T&                  reference;
+
+		const_iterator() : view(nullptr) {}
+
+		reference operator*() const
+        {
+            return *it;
+        }
+
+		pointer operator->() const
+        {
+			return &*it;
+		}
+
+		const_iterator operator++(int)
+        {
+			const_iterator tmp(*this);
+            ++*this;
+            return tmp;
+		}
+
+		const_iterator& operator++()
+        {
+            ++it;
+            skip();
+            return *this;
+		}
+
+		bool operator==(const const_iterator &other) const
+        {
+			return it == other.it;
+		}
+
+		bool operator!=(const const_iterator &other) const
+        {
+			return !(other == *this);
+		}
+
+	private:
+        const FilterView* view;
+        typename Set<T, Equal, Size>::const_iterator it;
+
+		friend class FilterView;
+
+		const_iterator(const FilterView* v, typename Set<T, Equal, Size>::const_iterator i) : view(v), it(i)
+        {
+            skip();
+        }
+
+        // Avanza fino al prossimo elemento che soddisfa il predicato
+        void skip()
+        {
+            typename Set<T, Equal, Size>::const_iterator e = view->mSet->end();
+            while(it != e && !view->mPred(*it))
+            {
+                ++it;
+            }
+        }
+	};
+
+    const_iterator begin() const
     {
-        if(pred(set[i]))
-            res.add(set[i]);
+        return const_iterator(this, mSet->begin());
     }
 
-    return res;
+    const_iterator end() const
+    {
+        return const_iterator(this, mSet->end());
+    }
+
+    /**
+     * @brief Numero di elementi che soddisfano il predicato.
+     */
+    size_type count() const
+    {
+        size_type n = 0;
+        for(typename Set<T, Equal, Size>::const_iterator i = mSet->begin(); i != mSet->end(); ++i)
+        {
+            if(mPred(*i))
+                n++;
+        }
+        return n;
+    }
+
+private:
+    const Set<T, Equal, Size>* mSet;  //Set osservato
+    Pred mPred;                       //Predicato di filtro
+};
+
+/**
+ * @brief Crea una vista filtrata di un set.
+ * 
+ * Funzione GLOBALE che ritorna una vista non proprietaria degli
+ * elementi di set che soddisfano il predicato pred.
+ * 
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Size Tipo delle dimensioni del set.
+ * @tparam Pred Predicato per il filtraggio.
+ * @param set Set di input.
+ * @param pred Predicato di filtro.
+ * @return FilterView<T, Equal, Pred, Size> Vista filtrata.
+ */
+template<typename T, typename Equal, typename Size, typename Pred>
+FilterView<T, Equal, Pred, Size> filter_view(const Set<T, Equal, Size>& set, Pred pred)
+{
+    return FilterView<T, Equal, Pred, Size>(set, pred);
+}
+
+/**
+ * @brief Filtra gli elementi di un set in base a un predicato.
+ * 
+ * Gli elementi del risultato sono un sottoinsieme di set,
+ * per cui vengono copiati senza controlli di unicità.
+ * 
+ * Funzione GLOBALE che ritorna un set contente 
+ * gli elementi di set che soddisfano il predicato pred.
+ * 
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Size Tipo delle dimensioni del set.
+ * @tparam Pred Predicato per il filtraggio.
+ * @param set Set di input.
+ * @param pred Predicato di filtro.
+ * @return Set<T, Equal, Size> Set filtrato.
+ */
+template<typename T, typename Equal, typename Size, typename Pred>
+Set<T, Equal, Size> filter_out(const Set<T, Equal, Size>& set, Pred pred)
+{
+    FilterView<T, Equal, Pred, Size> view(set, pred);
+    return Set<T, Equal, Size>(assume_unique, view.begin(), view.end());
 }
 
 /**
@@ -467,13 +1470,13 @@ Set<T, Equal> filter_out(const Set<T, Equal>& set, Pred pred)
  * @param set2 Altro set da unire.
  * @return Set Unione dei due set.
  */
-template<typename T, typename Equal>
-Set<T, Equal> operator+(const Set<T, Equal>& set1, const Set<T, Equal>& set2)
+template<typename T, typename Equal, typename Size>
+Set<T, Equal, Size> operator+(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
 {
-    Set<T, Equal> res(set1);
-    for(typename Set<T, Equal>::size_type i = 0; i < set2.getSize(); i++)
+    Set<T, Equal, Size> res(set1);
+    for(typename Set<T, Equal, Size>::const_iterator i = set2.begin(); i != set2.end(); ++i)
     {
-        res.add(set2[i]);
+        res.add(*i);
     }
 
     return res;
@@ -484,22 +1487,375 @@ Set<T, Equal> operator+(const Set<T, Equal>& set1, const Set<T, Equal>& set2)
  * 
  * Funzione GLOBALE che ritorna un set i cui elementi 
  * sono il risultato dell'intersezione dei due set passati come argomento.
+ * Il risultato è un sottoinsieme di set2 e non richiede controlli di unicità.
  * 
  * @param set1 Primo set da intersecare.
  * @param set2 Altro set da intersecare.
  * @return Set Intersezione dei due set.
  */
-template<typename T, typename Equal>
-Set<T, Equal> operator-(const Set<T, Equal>& set1, const Set<T, Equal>& set2)
+template<typename T, typename Equal, typename Size>
+Set<T, Equal, Size> operator-(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
+{
+    return filter_out(set2, [&set1](const T& value) { return set1.contains(value); });
+}
+
+/**
+ * @brief Cardinalità dell'intersezione tra due set.
+ * 
+ * Funzione GLOBALE che conta gli elementi comuni senza costruire
+ * l'intersezione: gli elementi del set più piccolo vengono cercati
+ * nel più grande.
+ * 
+ * @param set1 Primo set.
+ * @param set2 Altro set.
+ * @return size_type Numero di elementi comuni.
+ */
+template<typename T, typename Equal, typename Size>
+typename Set<T, Equal, Size>::size_type intersection_size(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
 {
-    Set<T, Equal> res;
-    for(typename Set<T, Equal>::size_type i = 0; i < set2.getSize(); i++)
+    const Set<T, Equal, Size>& small = set1.getSize() <= set2.getSize() ? set1 : set2;
+    const Set<T, Equal, Size>& large = set1.getSize() <= set2.getSize() ? set2 : set1;
+
+    typename Set<T, Equal, Size>::size_type count = 0;
+    for(typename Set<T, Equal, Size>::const_iterator i = small.begin(); i != small.end(); ++i)
     {
-        if(set1.contains(set2[i]))
-            res.add(set2[i]);
+        if(large.contains(*i))
+            count++;
     }
 
-    return res;
+    return count;
+}
+
+/**
+ * @brief Cardinalità dell'unione tra due set.
+ * 
+ * Funzione GLOBALE calcolata come |set1| + (|set2| - |set1 ∩ set2|),
+ * senza costruire l'unione.
+ * 
+ * @param set1 Primo set.
+ * @param set2 Altro set.
+ * @return size_type Numero di elementi dell'unione.
+ * 
+ * @throw std::length_error se il risultato non è rappresentabile in size_type.
+ */
+template<typename T, typename Equal, typename Size>
+typename Set<T, Equal, Size>::size_type union_size(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
+{
+    typedef typename Set<T, Equal, Size>::size_type size_type;
+
+    size_type rest = static_cast<size_type>(set2.getSize() - intersection_size(set1, set2));
+    if(set1.getSize() > std::numeric_limits<size_type>::max() - rest)
+        throw std::length_error("Set: capacità massima raggiunta");
+
+    return static_cast<size_type>(set1.getSize() + rest);
+}
+
+/**
+ * @brief Verifica se set1 è un sottoinsieme di set2.
+ * 
+ * Funzione GLOBALE che termina al primo elemento di set1
+ * assente in set2, o subito se set1 è più grande di set2.
+ * 
+ * @param set1 Set da verificare.
+ * @param set2 Set che dovrebbe contenerlo.
+ * @return true se ogni elemento di set1 è presente in set2.
+ * @return false altrimenti.
+ */
+template<typename T, typename Equal, typename Size>
+bool is_subset_of(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
+{
+    if(set1.getSize() > set2.getSize())
+        return false;
+
+    for(typename Set<T, Equal, Size>::const_iterator i = set1.begin(); i != set1.end(); ++i)
+    {
+        if(!set2.contains(*i))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Verifica se due set non hanno elementi in comune.
+ * 
+ * Funzione GLOBALE che cerca gli elementi del set più piccolo
+ * nel più grande e termina al primo elemento comune.
+ * 
+ * @param set1 Primo set.
+ * @param set2 Altro set.
+ * @return true se i set sono disgiunti.
+ * @return false altrimenti.
+ */
+template<typename T, typename Equal, typename Size>
+bool is_disjoint(const Set<T, Equal, Size>& set1, const Set<T, Equal, Size>& set2)
+{
+    const Set<T, Equal, Size>& small = set1.getSize() <= set2.getSize() ? set1 : set2;
+    const Set<T, Equal, Size>& large = set1.getSize() <= set2.getSize() ? set2 : set1;
+
+    for(typename Set<T, Equal, Size>::const_iterator i = small.begin(); i != small.end(); ++i)
+    {
+        if(large.contains(*i))
+            return false;
+    }
+
+    return true;
+}
+
+namespace gset_detail
+{
+    /**
+     * @brief Accesso in sola lettura all'array di slot di un Set.
+     * 
+     * Gli slot [0, slots) sono contigui; quelli con marcatore
+     * di rimozione a true non contengono elementi del set.
+     */
+    template<typename S>
+    struct SlotAccess
+    {
+        static const typename S::value_type* data(const S& set) { return set.mData; }
+        static typename S::size_type slots(const S& set) { return set.usedSlots(); }
+
+        // Marcatori di rimozione, nullptr se non ci sono slot rimossi
+        static const bool* dead(const S& set) { return set.mDeadCount > 0 ? set.mDead : nullptr; }
+    };
+
+    /**
+     * @brief Iteratore che dereferenzia una sequenza di puntatori.
+     */
+    template<typename T>
+    class IndirectIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T                         value_type;
+        typedef ptrdiff_t                 difference_type;
+        typedef const T*                  pointer;
+        typedef const T&                  reference;
+
+        explicit IndirectIterator(const T* const* pp) : p(pp) {}
+
+        reference operator*() const { return **p; }
+        pointer operator->() const { return *p; }
+        IndirectIterator& operator++() { ++p; return *this; }
+        IndirectIterator operator++(int) { IndirectIterator tmp(*this); ++p; return tmp; }
+        bool operator==(const IndirectIterator& other) const { return p == other.p; }
+        bool operator!=(const IndirectIterator& other) const { return p != other.p; }
+
+    private:
+        const T* const* p;
+    };
+
+    /**
+     * @brief Elemento di un set di input con il suo hash.
+     */
+    template<typename T>
+    struct HashedRef
+    {
+        const T* value;
+        std::size_t hash;
+    };
+
+    template<typename T>
+    struct HashedRefHash
+    {
+        std::size_t operator()(const HashedRef<T>& r) const { return r.hash; }
+    };
+
+    template<typename T, typename Equal>
+    struct HashedRefEqual
+    {
+        bool operator()(const HashedRef<T>& a, const HashedRef<T>& b) const
+        {
+            return a.hash == b.hash && eq(*a.value, *b.value);
+        }
+
+        Equal eq;
+    };
+
+    /**
+     * @brief Deduplica gli elementi la cui partizione di hash è part.
+     * 
+     * @param first Primo set di input.
+     * @param hashes Hash degli elementi, un vettore per ogni set di input.
+     * @param part Partizione da elaborare.
+     * @param parts Numero di partizioni.
+     * @param out Elementi distinti della partizione, in ordine di prima occorrenza.
+     */
+    template<typename Iter, typename T, typename Equal>
+    void dedupPartition(Iter first, const std::vector<std::vector<std::size_t> >& hashes,
+                        std::size_t part, std::size_t parts, std::vector<const T*>& out)
+    {
+        std::unordered_set<HashedRef<T>, HashedRefHash<T>, HashedRefEqual<T, Equal> > seen;
+
+        for(std::size_t k = 0; k < hashes.size(); ++k, ++first)
+        {
+            const std::vector<std::size_t>& h = hashes[k];
+            std::size_t i = 0;
+            for(typename std::iterator_traits<Iter>::value_type::const_iterator it = first->begin(); it != first->end(); ++it, ++i)
+            {
+                if(h[i] % parts != part)
+                    continue;
+
+                HashedRef<T> ref = { &*it, h[i] };
+                if(seen.insert(ref).second)
+                    out.push_back(ref.value);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Unione di una sequenza di set in un solo passaggio.
+ * 
+ * Funzione GLOBALE che ritorna l'unione dei set in [first, last).
+ * A differenza di una sequenza di operator+, il risultato viene
+ * allocato una sola volta e nessun set intermedio viene copiato.
+ * Senza funzione di hash, l'unicità è verificata confrontando
+ * ogni elemento con quelli già raccolti.
+ * 
+ * @tparam Iter Iteratore (almeno forward) su oggetti Set.
+ * @param first Iteratore al primo set.
+ * @param last Iteratore alla fine della sequenza di set.
+ * @return Set Unione dei set.
+ */
+template<typename Iter>
+typename std::iterator_traits<Iter>::value_type union_all(Iter first, Iter last)
+{
+    typedef typename std::iterator_traits<Iter>::value_type set_type;
+    typedef typename set_type::value_type T;
+
+    std::size_t total = 0;
+    for(Iter s = first; s != last; ++s)
+    {
+        total += s->getSize();
+    }
+
+    std::vector<const T*> unique;
+    unique.reserve(total);
+    typename set_type::key_equal eq;
+
+    for(Iter s = first; s != last; ++s)
+    {
+        std::size_t known = unique.size(); //Gli elementi di uno stesso set sono già distinti
+        for(typename set_type::const_iterator it = s->begin(); it != s->end(); ++it)
+        {
+            bool found = false;
+            for(std::size_t i = 0; i < known && !found; i++)
+            {
+                found = eq(*unique[i], *it);
+            }
+            if(!found)
+                unique.push_back(&*it);
+        }
+    }
+
+    const T* const* data = unique.empty() ? nullptr : &unique[0];
+    return set_type(assume_unique, gset_detail::IndirectIterator<T>(data),
+                    gset_detail::IndirectIterator<T>(data + unique.size()));
+}
+
+/**
+ * @brief Unione di una sequenza di set tramite hash, eventualmente in parallelo.
+ * 
+ * Funzione GLOBALE che ritorna l'unione dei set in [first, last),
+ * deduplicando tutti gli elementi con una tabella di hash.
+ * Con più thread gli hash vengono calcolati in parallelo sui set
+ * di input e la deduplicazione è suddivisa per partizioni di hash;
+ * in questo caso l'ordine degli elementi del risultato dipende
+ * dal numero di thread.
+ * 
+ * @tparam Iter Iteratore (almeno forward) su oggetti Set.
+ * @tparam Hash Funzione di hash coerente con il funtore di uguaglianza.
+ * @param first Iteratore al primo set.
+ * @param last Iteratore alla fine della sequenza di set.
+ * @param hash Funzione di hash.
+ * @param threads Numero di thread (0 = numero di core disponibili).
+ * @return Set Unione dei set.
+ */
+template<typename Iter, typename Hash>
+typename std::iterator_traits<Iter>::value_type union_all(Iter first, Iter last, Hash hash, unsigned threads = 1)
+{
+    typedef typename std::iterator_traits<Iter>::value_type set_type;
+    typedef typename set_type::value_type T;
+    typedef typename set_type::key_equal Equal;
+
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<Iter> inputs;
+    std::size_t total = 0;
+    for(Iter s = first; s != last; ++s)
+    {
+        inputs.push_back(s);
+        total += s->getSize();
+    }
+
+    if(threads > inputs.size() && inputs.size() > 0)
+        threads = static_cast<unsigned>(inputs.size());
+
+    // Calcolo degli hash, in parallelo sui set di input
+    std::vector<std::vector<std::size_t> > hashes(inputs.size());
+    auto hashInputs = [&](std::size_t from, std::size_t step)
+    {
+        for(std::size_t k = from; k < inputs.size(); k += step)
+        {
+            hashes[k].reserve(inputs[k]->getSize());
+            for(typename set_type::const_iterator it = inputs[k]->begin(); it != inputs[k]->end(); ++it)
+            {
+                hashes[k].push_back(hash(*it));
+            }
+        }
+    };
+
+    std::vector<std::vector<const T*> > parts(threads);
+    if(threads <= 1)
+    {
+        hashInputs(0, 1);
+        parts[0].reserve(total);
+        gset_detail::dedupPartition<Iter, T, Equal>(first, hashes, 0, 1, parts[0]);
+    }
+    else
+    {
+        std::vector<std::thread> pool;
+        for(unsigned t = 0; t < threads; t++)
+        {
+            pool.push_back(std::thread(hashInputs, t, threads));
+        }
+        for(unsigned t = 0; t < threads; t++)
+        {
+            pool[t].join();
+        }
+
+        pool.clear();
+        for(unsigned t = 0; t < threads; t++)
+        {
+            pool.push_back(std::thread(gset_detail::dedupPartition<Iter, T, Equal>, first, std::cref(hashes),
+                                       t, threads, std::ref(parts[t])));
+        }
+        for(unsigned t = 0; t < threads; t++)
+        {
+            pool[t].join();
+        }
+    }
+
+    std::vector<const T*> unique;
+    if(threads <= 1)
+    {
+        unique.swap(parts[0]);
+    }
+    else
+    {
+        unique.reserve(total);
+        for(unsigned t = 0; t < threads; t++)
+        {
+            unique.insert(unique.end(), parts[t].begin(), parts[t].end());
+        }
+    }
+
+    const T* const* data = unique.empty() ? nullptr : &unique[0];
+    return set_type(assume_unique, gset_detail::IndirectIterator<T>(data),
+                    gset_detail::IndirectIterator<T>(data + unique.size()));
 }
 
 /**
@@ -509,15 +1865,15 @@ Set<T, Equal> operator-(const Set<T, Equal>& set1, const Set<T, Equal>& set2)
  * @param set Set di stringhe di input.
  * @param path Percorso del file per salvare il set.
  */
-template<typename Equal>
-void save(const Set<std::string, Equal>& set, const std::string& path)
+template<typename Equal, typename Size>
+void save(const Set<std::string, Equal, Size>& set, const std::string& path)
 {
     try
     {
         std::ofstream file(path);
-        for(typename Set<std::string, Equal>::size_type i = 0; i < set.getSize(); i++)
+        for(typename Set<std::string, Equal, Size>::const_iterator i = set.begin(); i != set.end(); ++i)
         {
-            file << set[i] << '\n';
+            file << *i << '\n';
         }
     }
     catch(...)
@@ -526,4 +1882,29 @@ void save(const Set<std::string, Equal>& set, const std::string& path)
     }
 }
 
+/**
+ * @brief Carica un set di stringhe da un file scritto da save.
+ * 
+ * Ogni riga del file è aggiunta al set.
+ * 
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @param set Set di stringhe di destinazione.
+ * @param path Percorso del file da leggere.
+ * 
+ * @throw std::runtime_error se il file non può essere aperto.
+ */
+template<typename Equal, typename Size>
+void load(Set<std::string, Equal, Size>& set, const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file)
+        throw std::runtime_error("Impossibile aprire il file per la lettura");
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        set.add(line);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,560 @@
+/**
+ * @file gset_bitmap.hpp
+ *
+ * @brief file header della classe templata BitmapSet.
+ *
+ * Definizione e implementazione di un set di interi appartenenti
+ * a un intervallo noto, rappresentato tramite una bitmap.
+ */
+
+#ifndef GSET_BITMAP_HPP
+#define GSET_BITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "gset_bits.hpp"
+
+/**
+ * @brief Set di interi con universo limitato.
+ *
+ * La classe implementa un set di valori interi compresi
+ * nell'intervallo [Min, Max], utilizzando un bit per ogni
+ * valore possibile. Aggiunta, rimozione e ricerca richiedono
+ * tempo costante, mentre unione e intersezione operano
+ * su 64 valori alla volta.
+ *
+ * L'universo può contenere al più 2^32 valori (una bitmap di 512 MiB).
+ *
+ * @tparam T Tipo intero degli elementi nel set.
+ * @tparam Min Valore minimo ammesso.
+ * @tparam Max Valore massimo ammesso.
+ */
+template<typename T, T Min, T Max>
+class BitmapSet
+{
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "BitmapSet richiede un tipo intero");
+    static_assert(Min <= Max, "Intervallo [Min, Max] non valido");
+
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+
+    // Max - Min, calcolato senza overflow anche per tipi con segno
+    static const std::uint64_t SPAN = static_cast<unsigned_type>(static_cast<unsigned_type>(Max) -
+                                                                 static_cast<unsigned_type>(Min));
+
+    static_assert(SPAN < (std::uint64_t(1) << 32), "Universo [Min, Max] troppo grande per una bitmap");
+
+public:
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Costruttore di default.
+     *
+     * Alloca la bitmap per l'intero universo [Min, Max].
+     *
+     * @post mSize = 0.
+     *
+     * @throw Eccezione di allocazione
+     */
+    BitmapSet() : mWords(new std::uint64_t[wordCount()]()), mSize(0) {}
+
+    /**
+     * @brief Costruttore di copia.
+     *
+     * @param other Altro set da copiare.
+     *
+     * @throw Eccezione di allocazione
+     */
+    BitmapSet(const BitmapSet& other) : mWords(new std::uint64_t[wordCount()]), mSize(other.mSize)
+    {
+        std::memcpy(mWords, other.mWords, wordCount() * sizeof(std::uint64_t));
+    }
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     *
+     * @throw std::out_of_range se un valore è fuori dall'intervallo.
+     * @throw Eccezione di allocazione
+     */
+    template <typename Iter>
+    BitmapSet(Iter begin, Iter end) : mWords(new std::uint64_t[wordCount()]()), mSize(0)
+    {
+        try
+        {
+            for(; begin != end; ++begin)
+            {
+                add(static_cast<T>(*begin));
+            }
+        }
+        catch(...)
+        {
+            delete[] mWords;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Distruttore.
+     */
+    ~BitmapSet()
+    {
+        delete[] mWords;
+    }
+
+    /**
+     * @brief Operatore di assegnamento.
+     *
+     * @param other Altro set da assegnare.
+     * @return BitmapSet& Riferimento al set corrente.
+     */
+    BitmapSet& operator=(const BitmapSet& other)
+    {
+        if(this != &other)
+        {
+            std::memcpy(mWords, other.mWords, wordCount() * sizeof(std::uint64_t));
+            mSize = other.mSize;
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Aggiunge un elemento al set.
+     *
+     * @param value Valore da aggiungere.
+     * @return true Se l'elemento è stato aggiunto con successo.
+     * @return false Se l'elemento è già presente nel set.
+     *
+     * @throw std::out_of_range se il valore è fuori dall'intervallo.
+     */
+    bool add(T value)
+    {
+        if(!inRange(value))
+            throw std::out_of_range("value out of range");
+
+        std::uint64_t off = offset(value);
+        std::uint64_t mask = std::uint64_t(1) << (off % 64);
+        std::uint64_t& word = mWords[off / 64];
+
+        if(word & mask)
+            return false; //Elemento già presente
+
+        word |= mask;
+        mSize++;
+        return true;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set.
+     *
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(T value)
+    {
+        if(!inRange(value))
+            return false;
+
+        std::uint64_t off = offset(value);
+        std::uint64_t mask = std::uint64_t(1) << (off % 64);
+        std::uint64_t& word = mWords[off / 64];
+
+        if(!(word & mask))
+            return false; //Elemento assente
+
+        word &= ~mask;
+        mSize--;
+        return true;
+    }
+
+    /**
+     * @brief Verifica se un elemento è presente nel set.
+     *
+     * @param value Valore da cercare.
+     * @return true se l'elemento è presente.
+     * @return false se l'elemento non è presente.
+     */
+    bool contains(T value) const
+    {
+        if(!inRange(value))
+            return false;
+
+        std::uint64_t off = offset(value);
+        return (mWords[off / 64] >> (off % 64)) & 1;
+    }
+
+    /**
+     * @brief Svuota il set.
+     *
+     * La bitmap rimane allocata, dato che la sua dimensione
+     * dipende solo dall'intervallo [Min, Max].
+     *
+     * @post mSize = 0
+     */
+    void empty()
+    {
+        std::memset(mWords, 0, wordCount() * sizeof(std::uint64_t));
+        mSize = 0;
+    }
+
+    /**
+     * @brief Operatore di accesso agli elementi del set.
+     *
+     * Gli elementi sono restituiti in ordine crescente.
+     * Richiede una scansione della bitmap (conteggio dei bit per parola).
+     *
+     * @param index Indice dell'elemento.
+     * @return T elemento.
+     *
+     * @throw std::out_of_range se l'indice è fuori dai limit.
+     */
+    T operator[](size_type index) const
+    {
+        if(index >= mSize)
+            throw std::out_of_range("index out of bounds"); //index out of bounds
+
+        size_type w = 0;
+        for(;; w++)
+        {
+            unsigned count = gset_detail::popcount64(mWords[w]);
+            if(index < count)
+                break;
+            index -= count;
+        }
+
+        std::uint64_t word = mWords[w];
+        for(; index > 0; index--)
+        {
+            word &= word - 1;
+        }
+
+        return valueAt(w * 64 + gset_detail::ctz64(word));
+    }
+
+    /**
+     * @brief Operatore di confronto di uguaglianza tra set.
+     *
+     * @param other Altro set da confrontare.
+     * @return true Se i set sono uguali.
+     * @return false Se i set non sono uguali.
+     */
+    bool operator==(const BitmapSet& other) const
+    {
+        return mSize == other.mSize &&
+               std::memcmp(mWords, other.mWords, wordCount() * sizeof(std::uint64_t)) == 0;
+    }
+
+    /**
+     * @brief Operatore di stream per la stampa del set.
+     *
+     * @param out Stream di output.
+     * @param set Set da stampare.
+     * @return std::ostream& Stream di output.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const BitmapSet& set)
+    {
+        out << set.mSize;
+        for(const_iterator i = set.begin(); i != set.end(); ++i)
+        {
+            out << " (" << +*i << ")";
+        }
+
+        return out;
+    }
+
+    size_type getSize() const { return mSize; }
+    size_type getCapacity() const { return static_cast<size_type>(universe()); }
+
+    ///CONST ITERATOR
+
+    class const_iterator {
+		//
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef T                         reference;
+
+		const_iterator() : words(nullptr), count(0), w(0), bits(0) {}
+
+		// Ritorna il valore riferito dall'iteratore (calcolato dalla posizione del bit)
+		reference operator*() const
+        {
+            return BitmapSet::valueAt(w * 64 + gset_detail::ctz64(bits));
+        }
+
+		// Operatore di iterazione post-incremento
+		const_iterator operator++(int)
+        {
+			const_iterator tmp(*this);
+            ++*this;
+            return tmp;
+		}
+
+		// Operatore di iterazione pre-incremento
+		const_iterator& operator++()
+        {
+            bits &= bits - 1;
+            skipEmpty();
+            return *this;
+		}
+
+		// Uguaglianza
+		bool operator==(const const_iterator &other) const
+        {
+			return w == other.w && bits == other.bits;
+		}
+
+		// Diversita'
+		bool operator!=(const const_iterator &other) const
+        {
+			return !(other == *this);
+		}
+
+	private:
+		//Dati membro
+        const std::uint64_t* words;
+        size_type count;
+        size_type w;
+        std::uint64_t bits;
+
+		friend class BitmapSet;
+
+		// Costruttore privato di inizializzazione usato dalla classe container
+		const_iterator(const std::uint64_t* ww, size_type cc, size_type pos)
+            : words(ww), count(cc), w(pos), bits(pos < cc ? ww[pos] : 0)
+        {
+            skipEmpty();
+        }
+
+        // Avanza fino alla prossima parola con almeno un bit a 1
+        void skipEmpty()
+        {
+            while(bits == 0 && w < count)
+            {
+                w++;
+                if(w < count)
+                    bits = words[w];
+            }
+        }
+
+	}; // classe const_iterator
+
+	/**
+     * @brief Ritorna l'iteratore all'inizio della sequenza dati.
+     *
+     * @return const_iterator Iteratore all'inizio della sequenza dati.
+     */
+	const_iterator begin() const
+    {
+		return const_iterator(mWords, wordCount(), 0);
+	}
+
+	/**
+     * @brief Ritorna l'iteratore alla fine della sequenza dati.
+     *
+     * @return const_iterator Iteratore alla fine della sequenza dati.
+     */
+	const_iterator end() const
+    {
+		return const_iterator(mWords, wordCount(), wordCount());
+	}
+
+    /**
+     * @brief Unione con un altro set, parola per parola.
+     *
+     * @param other Altro set da unire.
+     * @return BitmapSet& Riferimento al set corrente.
+     */
+    BitmapSet& operator|=(const BitmapSet& other)
+    {
+        mSize = 0;
+        for(size_type i = 0; i < wordCount(); i++)
+        {
+            mWords[i] |= other.mWords[i];
+            mSize += gset_detail::popcount64(mWords[i]);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Intersezione con un altro set, parola per parola.
+     *
+     * @param other Altro set da intersecare.
+     * @return BitmapSet& Riferimento al set corrente.
+     */
+    BitmapSet& operator&=(const BitmapSet& other)
+    {
+        mSize = 0;
+        for(size_type i = 0; i < wordCount(); i++)
+        {
+            mWords[i] &= other.mWords[i];
+            mSize += gset_detail::popcount64(mWords[i]);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Cardinalità dell'intersezione tra set bitmap.
+     *
+     * Funzione GLOBALE che somma il popcount dell'AND parola per parola,
+     * senza costruire l'intersezione.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi comuni.
+     */
+    friend size_type intersection_size(const BitmapSet& set1, const BitmapSet& set2)
+    {
+        size_type count = 0;
+        for(size_type i = 0; i < wordCount(); i++)
+        {
+            count += gset_detail::popcount64(set1.mWords[i] & set2.mWords[i]);
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Cardinalità dell'unione tra set bitmap.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi dell'unione.
+     */
+    friend size_type union_size(const BitmapSet& set1, const BitmapSet& set2)
+    {
+        return set1.mSize + set2.mSize - intersection_size(set1, set2);
+    }
+
+    /**
+     * @brief Verifica se set1 è un sottoinsieme di set2.
+     *
+     * Termina alla prima parola con un bit di set1 assente in set2.
+     *
+     * @param set1 Set da verificare.
+     * @param set2 Set che dovrebbe contenerlo.
+     * @return true se ogni elemento di set1 è presente in set2.
+     * @return false altrimenti.
+     */
+    friend bool is_subset_of(const BitmapSet& set1, const BitmapSet& set2)
+    {
+        if(set1.mSize > set2.mSize)
+            return false;
+
+        for(size_type i = 0; i < wordCount(); i++)
+        {
+            if((set1.mWords[i] & ~set2.mWords[i]) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Verifica se due set bitmap non hanno elementi in comune.
+     *
+     * Termina alla prima parola con un bit comune.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return true se i set sono disgiunti.
+     * @return false altrimenti.
+     */
+    friend bool is_disjoint(const BitmapSet& set1, const BitmapSet& set2)
+    {
+        for(size_type i = 0; i < wordCount(); i++)
+        {
+            if((set1.mWords[i] & set2.mWords[i]) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    // Numero di valori nell'intervallo [Min, Max]
+    static std::uint64_t universe()
+    {
+        return SPAN + 1;
+    }
+
+    // Numero di parole a 64 bit della bitmap
+    static size_type wordCount()
+    {
+        return static_cast<size_type>((universe() + 63) / 64);
+    }
+
+    static bool inRange(T value)
+    {
+        return !(value < Min) && !(Max < value);
+    }
+
+    // Posizione del bit associato a value
+    static std::uint64_t offset(T value)
+    {
+        return static_cast<unsigned_type>(static_cast<unsigned_type>(value) - static_cast<unsigned_type>(Min));
+    }
+
+    // Valore associato alla posizione off
+    static T valueAt(std::uint64_t off)
+    {
+        return static_cast<T>(static_cast<unsigned_type>(static_cast<unsigned_type>(Min) + static_cast<unsigned_type>(off)));
+    }
+
+private:
+    std::uint64_t* mWords;  //Bitmap, un bit per ogni valore possibile
+    size_type mSize;        //Numero di elementi presenti
+};
+
+/**
+ * @brief Operatore di unione tra set bitmap.
+ *
+ * Funzione GLOBALE che ritorna un set i cui elementi
+ * sono il risultato dell'unione dei due set passati come argomento.
+ *
+ * @param set1 Primo set da unire.
+ * @param set2 Altro set da unire.
+ * @return BitmapSet Unione dei due set.
+ */
+template<typename T, T Min, T Max>
+BitmapSet<T, Min, Max> operator+(const BitmapSet<T, Min, Max>& set1, const BitmapSet<T, Min, Max>& set2)
+{
+    BitmapSet<T, Min, Max> res(set1);
+    res |= set2;
+    return res;
+}
+
+/**
+ * @brief Operatore di intersezione tra set bitmap.
+ *
+ * Funzione GLOBALE che ritorna un set i cui elementi
+ * sono il risultato dell'intersezione dei due set passati come argomento.
+ *
+ * @param set1 Primo set da intersecare.
+ * @param set2 Altro set da intersecare.
+ * @return BitmapSet Intersezione dei due set.
+ */
+template<typename T, T Min, T Max>
+BitmapSet<T, Min, Max> operator-(const BitmapSet<T, Min, Max>& set1, const BitmapSet<T, Min, Max>& set2)
+{
+    BitmapSet<T, Min, Max> res(set1);
+    res &= set2;
+    return res;
+}
+
+#endif
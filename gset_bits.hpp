@@ -0,0 +1,83 @@
+/**
+ * @file gset_bits.hpp
+ *
+ * @brief file header delle funzioni di manipolazione dei bit.
+ *
+ * Conteggio dei bit a 1 e degli zeri iniziali e finali di una parola
+ * a 64 bit, condivisi dai set bitmap, compressi e dagli sketch.
+ */
+
+#ifndef GSET_BITS_HPP
+#define GSET_BITS_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace gset_detail
+{
+    /**
+     * @brief Numero di bit a 1 in una parola a 64 bit.
+     */
+    inline unsigned popcount64(std::uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<unsigned>(__popcnt64(word));
+#else
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    /**
+     * @brief Indice del bit a 1 meno significativo (word deve essere != 0).
+     */
+    inline unsigned ctz64(std::uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        unsigned index = 0;
+        while((word & 1) == 0)
+        {
+            word >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    /**
+     * @brief Numero di bit a 0 più significativi (word deve essere != 0).
+     */
+    inline unsigned clz64(std::uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_clzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, word);
+        return 63u - static_cast<unsigned>(index);
+#else
+        unsigned count = 0;
+        while((word & (std::uint64_t(1) << 63)) == 0)
+        {
+            word <<= 1;
+            count++;
+        }
+        return count;
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,1296 @@
+/**
+ * @file gset_compressed.hpp
+ *
+ * @brief file header della classe CompressedSet.
+ *
+ * Definizione e implementazione di un set compresso di interi
+ * a 32 bit, in stile Roaring bitmap.
+ */
+
+#ifndef GSET_COMPRESSED_HPP
+#define GSET_COMPRESSED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gset_bits.hpp"
+
+/**
+ * @brief Set compresso di interi a 32 bit.
+ *
+ * Lo spazio dei valori è suddiviso in blocchi da 65536 valori,
+ * indicizzati dai 16 bit più significativi. Per ogni blocco non vuoto
+ * viene scelto il contenitore più compatto tra:
+ * - array ordinato di valori a 16 bit (fino a 4096 elementi);
+ * - bitmap da 65536 bit (oltre 4096 elementi);
+ * - sequenza di intervalli consecutivi (run), scelta da runOptimize.
+ *
+ * Unione e intersezione operano blocco per blocco, senza
+ * espandere i contenitori in valori singoli quando non necessario.
+ */
+class CompressedSet
+{
+public:
+    typedef std::uint32_t value_type;
+    typedef std::uint64_t size_type;
+
+private:
+    enum ContainerType
+    {
+        ARRAY_CONTAINER = 0,
+        BITMAP_CONTAINER = 1,
+        RUN_CONTAINER = 2
+    };
+
+    static const std::uint32_t ARRAY_MAX = 4096;  //Cardinalità massima di un array
+    static const std::size_t BITMAP_WORDS = 1024; //Parole a 64 bit di una bitmap
+
+    /**
+     * @brief Contenitore dei valori di un blocco da 65536 elementi.
+     *
+     * Per gli array values contiene i valori ordinati, per i run
+     * le coppie (inizio, lunghezza - 1). Per le bitmap i bit
+     * sono memorizzati in words.
+     */
+    struct Container
+    {
+        std::uint16_t key;                  //16 bit più significativi dei valori
+        unsigned char type;                 //Tipo di contenitore
+        std::uint32_t card;                 //Numero di valori presenti
+        std::vector<std::uint16_t> values;  //Array o run
+        std::vector<std::uint64_t> words;   //Bitmap
+    };
+
+public:
+    /**
+     * @brief Costruttore di default.
+     *
+     * @post mSize = 0.
+     */
+    CompressedSet() : mSize(0) {}
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     *
+     * @throw Errore di allocazione
+     */
+    template <typename Iter>
+    CompressedSet(Iter begin, Iter end) : mSize(0)
+    {
+        for(; begin != end; ++begin)
+        {
+            add(static_cast<value_type>(*begin));
+        }
+    }
+
+    /**
+     * @brief Aggiunge un elemento al set.
+     *
+     * Un contenitore run viene espanso prima della modifica;
+     * un array che supera 4096 elementi diventa una bitmap.
+     *
+     * @param value Valore da aggiungere.
+     * @return true Se l'elemento è stato aggiunto con successo.
+     * @return false Se l'elemento è già presente nel set.
+     */
+    bool add(value_type value)
+    {
+        std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+        std::uint16_t low = static_cast<std::uint16_t>(value & 0xFFFF);
+
+        std::vector<Container>::iterator it = findChunk(key);
+        if(it == mChunks.end() || it->key != key)
+        {
+            Container c;
+            c.key = key;
+            c.type = ARRAY_CONTAINER;
+            c.card = 1;
+            c.values.push_back(low);
+            mChunks.insert(it, c);
+            mSize++;
+            return true;
+        }
+
+        Container& c = *it;
+        if(c.type == RUN_CONTAINER)
+            expandRun(c);
+
+        if(c.type == ARRAY_CONTAINER)
+        {
+            std::vector<std::uint16_t>::iterator pos = std::lower_bound(c.values.begin(), c.values.end(), low);
+            if(pos != c.values.end() && *pos == low)
+                return false; //Elemento già presente
+
+            c.values.insert(pos, low);
+            c.card++;
+            if(c.card > ARRAY_MAX)
+                makeBitmap(c);
+        }
+        else
+        {
+            std::uint64_t mask = std::uint64_t(1) << (low % 64);
+            if(c.words[low / 64] & mask)
+                return false; //Elemento già presente
+
+            c.words[low / 64] |= mask;
+            c.card++;
+        }
+
+        mSize++;
+        return true;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set.
+     *
+     * Una bitmap che scende a 4096 elementi torna a essere un array;
+     * i blocchi vuoti vengono eliminati.
+     *
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(value_type value)
+    {
+        std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+        std::uint16_t low = static_cast<std::uint16_t>(value & 0xFFFF);
+
+        std::vector<Container>::iterator it = findChunk(key);
+        if(it == mChunks.end() || it->key != key || !containerContains(*it, low))
+            return false; //Elemento assente
+
+        Container& c = *it;
+        if(c.type == RUN_CONTAINER)
+            expandRun(c);
+
+        if(c.type == ARRAY_CONTAINER)
+        {
+            c.values.erase(std::lower_bound(c.values.begin(), c.values.end(), low));
+        }
+        else
+        {
+            c.words[low / 64] &= ~(std::uint64_t(1) << (low % 64));
+        }
+        c.card--;
+        mSize--;
+
+        if(c.card == 0)
+            mChunks.erase(it);
+        else
+            normalize(c);
+
+        return true;
+    }
+
+    /**
+     * @brief Verifica se un elemento è presente nel set.
+     *
+     * @param value Valore da cercare.
+     * @return true se l'elemento è presente.
+     * @return false se l'elemento non è presente.
+     */
+    bool contains(value_type value) const
+    {
+        std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+        std::vector<Container>::const_iterator it = findChunk(key);
+
+        return it != mChunks.end() && it->key == key &&
+               containerContains(*it, static_cast<std::uint16_t>(value & 0xFFFF));
+    }
+
+    /**
+     * @brief Svuota il set.
+     *
+     * @post mSize = 0
+     */
+    void empty()
+    {
+        std::vector<Container>().swap(mChunks);
+        mSize = 0;
+    }
+
+    /**
+     * @brief Converte in run i contenitori per cui è la forma più compatta.
+     *
+     * Da chiamare dopo la costruzione di set con lunghe sequenze
+     * di valori consecutivi. I contenitori run già presenti che non
+     * risultano più convenienti vengono espansi.
+     *
+     * @return true Se almeno un contenitore è stato convertito.
+     */
+    bool runOptimize()
+    {
+        bool changed = false;
+        for(std::size_t i = 0; i < mChunks.size(); i++)
+        {
+            Container& c = mChunks[i];
+
+            std::vector<std::uint16_t> runs;
+            buildRuns(c, runs);
+
+            std::size_t runBytes = runs.size() * sizeof(std::uint16_t);
+            std::size_t plainBytes = c.card <= ARRAY_MAX ? c.card * sizeof(std::uint16_t)
+                                                         : BITMAP_WORDS * sizeof(std::uint64_t);
+
+            if(runBytes < plainBytes)
+            {
+                if(c.type != RUN_CONTAINER)
+                {
+                    c.values.swap(runs);
+                    std::vector<std::uint64_t>().swap(c.words);
+                    c.type = RUN_CONTAINER;
+                    changed = true;
+                }
+            }
+            else if(c.type == RUN_CONTAINER)
+            {
+                expandRun(c);
+                changed = true;
+            }
+        }
+
+        return changed;
+    }
+
+    /**
+     * @brief Operatore di accesso agli elementi del set.
+     *
+     * Gli elementi sono restituiti in ordine crescente.
+     *
+     * @param index Indice dell'elemento.
+     * @return value_type elemento.
+     *
+     * @throw std::out_of_range se l'indice è fuori dai limit.
+     */
+    value_type operator[](size_type index) const
+    {
+        if(index >= mSize)
+            throw std::out_of_range("index out of bounds"); //index out of bounds
+
+        std::size_t ci = 0;
+        while(index >= mChunks[ci].card)
+        {
+            index -= mChunks[ci].card;
+            ci++;
+        }
+
+        const Container& c = mChunks[ci];
+        std::uint32_t low = 0;
+        if(c.type == ARRAY_CONTAINER)
+        {
+            low = c.values[static_cast<std::size_t>(index)];
+        }
+        else if(c.type == RUN_CONTAINER)
+        {
+            for(std::size_t r = 0; ; r += 2)
+            {
+                std::uint32_t length = c.values[r + 1] + 1u;
+                if(index < length)
+                {
+                    low = c.values[r] + static_cast<std::uint32_t>(index);
+                    break;
+                }
+                index -= length;
+            }
+        }
+        else
+        {
+            std::size_t w = 0;
+            for(;; w++)
+            {
+                unsigned count = gset_detail::popcount64(c.words[w]);
+                if(index < count)
+                    break;
+                index -= count;
+            }
+
+            std::uint64_t word = c.words[w];
+            for(; index > 0; index--)
+            {
+                word &= word - 1;
+            }
+            low = static_cast<std::uint32_t>(w * 64 + gset_detail::ctz64(word));
+        }
+
+        return (static_cast<value_type>(c.key) << 16) | low;
+    }
+
+    /**
+     * @brief Operatore di confronto di uguaglianza tra set.
+     *
+     * Due set sono uguali se contengono gli stessi valori,
+     * indipendentemente dal tipo di contenitore scelto per ogni blocco.
+     *
+     * @param other Altro set da confrontare.
+     * @return true Se i set sono uguali.
+     * @return false Se i set non sono uguali.
+     */
+    bool operator==(const CompressedSet& other) const
+    {
+        if(mSize != other.mSize || mChunks.size() != other.mChunks.size())
+            return false;
+
+        for(std::size_t i = 0; i < mChunks.size(); i++)
+        {
+            const Container& a = mChunks[i];
+            const Container& b = other.mChunks[i];
+            if(a.key != b.key || a.card != b.card)
+                return false;
+
+            if(a.type == b.type)
+            {
+                if(a.values != b.values || a.words != b.words)
+                    return false;
+            }
+            else
+            {
+                std::vector<std::uint64_t> wa, wb;
+                toBitmap(a, wa);
+                toBitmap(b, wb);
+                if(wa != wb)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Operatore di stream per la stampa del set.
+     *
+     * @param out Stream di output.
+     * @param set Set da stampare.
+     * @return std::ostream& Stream di output.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const CompressedSet& set)
+    {
+        out << set.mSize;
+        for(const_iterator i = set.begin(); i != set.end(); ++i)
+        {
+            out << " (" << *i << ")";
+        }
+
+        return out;
+    }
+
+    size_type getSize() const { return mSize; }
+
+    /**
+     * @brief Numero di blocchi da 65536 valori non vuoti.
+     */
+    std::size_t getChunkCount() const { return mChunks.size(); }
+
+    /**
+     * @brief Memoria occupata dal set, in byte.
+     *
+     * Comprende la struttura stessa e i buffer allocati dai contenitori.
+     */
+    std::size_t memory_usage() const
+    {
+        std::size_t bytes = sizeof(*this) + mChunks.capacity() * sizeof(Container);
+        for(std::size_t i = 0; i < mChunks.size(); i++)
+        {
+            bytes += mChunks[i].values.capacity() * sizeof(std::uint16_t);
+            bytes += mChunks[i].words.capacity() * sizeof(std::uint64_t);
+        }
+
+        return bytes;
+    }
+
+    /**
+     * @brief Scrive il set su uno stream binario.
+     *
+     * Formato (little endian): "GSRS", numero di blocchi (32 bit),
+     * poi per ogni blocco chiave (16 bit), tipo (8 bit), cardinalità (32 bit)
+     * e il contenuto del contenitore: i valori per gli array,
+     * 1024 parole a 64 bit per le bitmap, numero di run (32 bit)
+     * seguito dalle coppie (inizio, lunghezza - 1) per i run.
+     *
+     * @param out Stream di output (aperto in modalità binaria).
+     */
+    void serialize(std::ostream& out) const
+    {
+        out.write("GSRS", 4);
+        writeLE(out, mChunks.size(), 4);
+
+        for(std::size_t i = 0; i < mChunks.size(); i++)
+        {
+            const Container& c = mChunks[i];
+            writeLE(out, c.key, 2);
+            writeLE(out, c.type, 1);
+            writeLE(out, c.card, 4);
+
+            if(c.type == BITMAP_CONTAINER)
+            {
+                for(std::size_t w = 0; w < BITMAP_WORDS; w++)
+                {
+                    writeLE(out, c.words[w], 8);
+                }
+            }
+            else
+            {
+                if(c.type == RUN_CONTAINER)
+                    writeLE(out, c.values.size() / 2, 4);
+                for(std::size_t v = 0; v < c.values.size(); v++)
+                {
+                    writeLE(out, c.values[v], 2);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Legge il set da uno stream binario scritto da serialize.
+     *
+     * Il contenuto precedente del set viene sostituito.
+     * Ogni contenitore viene validato (chiavi crescenti, array ordinati,
+     * run disgiunti, cardinalità coerenti) prima di essere accettato.
+     *
+     * @param in Stream di input (aperto in modalità binaria).
+     *
+     * @throw std::runtime_error se lo stream non contiene un set valido.
+     */
+    void deserialize(std::istream& in)
+    {
+        char magic[4];
+        if(!in.read(magic, 4) || std::string(magic, 4) != "GSRS")
+            throw std::runtime_error("Formato del file non valido");
+
+        std::uint64_t chunkCount = readLE(in, 4);
+        if(chunkCount > 65536)
+            throw std::runtime_error("Formato del file non valido");
+
+        std::vector<Container> chunks(static_cast<std::size_t>(chunkCount));
+        size_type size = 0;
+
+        for(std::size_t i = 0; i < chunks.size(); i++)
+        {
+            Container& c = chunks[i];
+            c.key = static_cast<std::uint16_t>(readLE(in, 2));
+            c.type = static_cast<unsigned char>(readLE(in, 1));
+            c.card = static_cast<std::uint32_t>(readLE(in, 4));
+
+            if(i > 0 && c.key <= chunks[i - 1].key)
+                throw std::runtime_error("Formato del file non valido");
+
+            std::size_t count = 0;
+            if(c.type == ARRAY_CONTAINER && c.card <= ARRAY_MAX)
+                count = c.card;
+            else if(c.type == RUN_CONTAINER)
+                count = static_cast<std::size_t>(readLE(in, 4)) * 2;
+            else if(c.type == BITMAP_CONTAINER)
+                c.words.resize(BITMAP_WORDS);
+            else
+                throw std::runtime_error("Formato del file non valido"); //Tipo sconosciuto o array troppo grande
+
+            if(count > 2 * 65536)
+                throw std::runtime_error("Formato del file non valido");
+
+            c.values.resize(count);
+            for(std::size_t v = 0; v < count; v++)
+            {
+                c.values[v] = static_cast<std::uint16_t>(readLE(in, 2));
+            }
+            for(std::size_t w = 0; w < c.words.size(); w++)
+            {
+                c.words[w] = readLE(in, 8);
+            }
+
+            if(!isValid(c))
+                throw std::runtime_error("Formato del file non valido");
+            size += c.card;
+        }
+
+        mChunks.swap(chunks);
+        mSize = size;
+    }
+
+    ///CONST ITERATOR
+
+    class const_iterator {
+		//
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef CompressedSet::value_type value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const value_type*         pointer;
+		typedef value_type                reference;
+
+		const_iterator() : chunks(nullptr), ci(0), pos(0), bits(0) {}
+
+		// Ritorna il valore riferito dall'iteratore
+		reference operator*() const
+        {
+            const Container& c = (*chunks)[ci];
+            std::uint32_t low;
+            if(c.type == ARRAY_CONTAINER)
+                low = c.values[pos];
+            else if(c.type == RUN_CONTAINER)
+                low = c.values[2 * pos] + static_cast<std::uint32_t>(bits);
+            else
+                low = static_cast<std::uint32_t>(pos * 64 + gset_detail::ctz64(bits));
+
+            return (static_cast<value_type>(c.key) << 16) | low;
+        }
+
+		// Operatore di iterazione post-incremento
+		const_iterator operator++(int)
+        {
+			const_iterator tmp(*this);
+            ++*this;
+            return tmp;
+		}
+
+		// Operatore di iterazione pre-incremento
+		const_iterator& operator++()
+        {
+            const Container& c = (*chunks)[ci];
+            if(c.type == ARRAY_CONTAINER)
+            {
+                pos++;
+            }
+            else if(c.type == RUN_CONTAINER)
+            {
+                if(bits == c.values[2 * pos + 1])
+                {
+                    pos++;
+                    bits = 0;
+                }
+                else
+                {
+                    bits++;
+                }
+            }
+            else
+            {
+                bits &= bits - 1;
+            }
+
+            settle();
+            return *this;
+		}
+
+		// Uguaglianza
+		bool operator==(const const_iterator &other) const
+        {
+			return ci == other.ci && pos == other.pos && bits == other.bits;
+		}
+
+		// Diversita'
+		bool operator!=(const const_iterator &other) const
+        {
+			return !(other == *this);
+		}
+
+	private:
+		//Dati membro
+        const std::vector<Container>* chunks;
+        std::size_t ci;     //Indice del blocco corrente
+        std::size_t pos;    //Indice nell'array, parola della bitmap o indice del run
+        std::uint64_t bits; //Bit residui della parola o posizione nel run
+
+		friend class CompressedSet;
+
+		// Costruttore privato di inizializzazione usato dalla classe container
+		const_iterator(const std::vector<Container>* cc, std::size_t index)
+            : chunks(cc), ci(index), pos(0), bits(0)
+        {
+            if(ci < chunks->size() && (*chunks)[ci].type == BITMAP_CONTAINER)
+                bits = (*chunks)[ci].words[0];
+            settle();
+        }
+
+        // Porta l'iteratore su una posizione valida o sulla fine della sequenza
+        void settle()
+        {
+            while(ci < chunks->size())
+            {
+                const Container& c = (*chunks)[ci];
+                if(c.type == ARRAY_CONTAINER && pos < c.values.size())
+                    return;
+                if(c.type == RUN_CONTAINER && 2 * pos < c.values.size())
+                    return;
+                if(c.type == BITMAP_CONTAINER)
+                {
+                    while(bits == 0 && ++pos < BITMAP_WORDS)
+                    {
+                        bits = c.words[pos];
+                    }
+                    if(bits != 0)
+                        return;
+                }
+
+                ci++;
+                pos = 0;
+                bits = (ci < chunks->size() && (*chunks)[ci].type == BITMAP_CONTAINER) ? (*chunks)[ci].words[0] : 0;
+            }
+
+            pos = 0;
+            bits = 0;
+        }
+
+	}; // classe const_iterator
+
+	/**
+     * @brief Ritorna l'iteratore all'inizio della sequenza dati.
+     *
+     * @return const_iterator Iteratore all'inizio della sequenza dati.
+     */
+	const_iterator begin() const
+    {
+		return const_iterator(&mChunks, 0);
+	}
+
+	/**
+     * @brief Ritorna l'iteratore alla fine della sequenza dati.
+     *
+     * @return const_iterator Iteratore alla fine della sequenza dati.
+     */
+	const_iterator end() const
+    {
+		return const_iterator(&mChunks, mChunks.size());
+	}
+
+    /**
+     * @brief Operatore di unione tra set compressi.
+     *
+     * Funzione GLOBALE che unisce i contenitori con la stessa chiave
+     * e copia quelli presenti in uno solo dei due set.
+     *
+     * @param set1 Primo set da unire.
+     * @param set2 Altro set da unire.
+     * @return CompressedSet Unione dei due set.
+     */
+    friend CompressedSet operator+(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        CompressedSet res;
+        res.mChunks.reserve(set1.mChunks.size() + set2.mChunks.size());
+
+        std::size_t i = 0, j = 0;
+        while(i < set1.mChunks.size() || j < set2.mChunks.size())
+        {
+            if(j == set2.mChunks.size() || (i < set1.mChunks.size() && set1.mChunks[i].key < set2.mChunks[j].key))
+            {
+                res.mChunks.push_back(set1.mChunks[i++]);
+            }
+            else if(i == set1.mChunks.size() || set2.mChunks[j].key < set1.mChunks[i].key)
+            {
+                res.mChunks.push_back(set2.mChunks[j++]);
+            }
+            else
+            {
+                res.mChunks.push_back(Container());
+                unite(set1.mChunks[i++], set2.mChunks[j++], res.mChunks.back());
+            }
+            res.mSize += res.mChunks.back().card;
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Operatore di intersezione tra set compressi.
+     *
+     * Funzione GLOBALE che interseca solo i contenitori
+     * con la stessa chiave presenti in entrambi i set.
+     *
+     * @param set1 Primo set da intersecare.
+     * @param set2 Altro set da intersecare.
+     * @return CompressedSet Intersezione dei due set.
+     */
+    friend CompressedSet operator-(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        CompressedSet res;
+
+        std::size_t i = 0, j = 0;
+        while(i < set1.mChunks.size() && j < set2.mChunks.size())
+        {
+            if(set1.mChunks[i].key < set2.mChunks[j].key)
+            {
+                i++;
+            }
+            else if(set2.mChunks[j].key < set1.mChunks[i].key)
+            {
+                j++;
+            }
+            else
+            {
+                Container c;
+                intersect(set1.mChunks[i++], set2.mChunks[j++], c);
+                if(c.card > 0)
+                {
+                    res.mSize += c.card;
+                    res.mChunks.push_back(Container());
+                    res.mChunks.back().key = c.key;
+                    res.mChunks.back().type = c.type;
+                    res.mChunks.back().card = c.card;
+                    res.mChunks.back().values.swap(c.values);
+                    res.mChunks.back().words.swap(c.words);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Cardinalità dell'intersezione tra set compressi.
+     *
+     * Funzione GLOBALE che conta i valori comuni dei contenitori
+     * con la stessa chiave, senza costruire l'intersezione.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi comuni.
+     */
+    friend size_type intersection_size(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        return countCommon(set1, set2, false);
+    }
+
+    /**
+     * @brief Cardinalità dell'unione tra set compressi.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi dell'unione.
+     */
+    friend size_type union_size(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        return set1.mSize + set2.mSize - countCommon(set1, set2, false);
+    }
+
+    /**
+     * @brief Verifica se set1 è un sottoinsieme di set2.
+     *
+     * Termina al primo contenitore di set1 senza corrispondente
+     * in set2 o non interamente contenuto in esso.
+     *
+     * @param set1 Set da verificare.
+     * @param set2 Set che dovrebbe contenerlo.
+     * @return true se ogni elemento di set1 è presente in set2.
+     * @return false altrimenti.
+     */
+    friend bool is_subset_of(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        if(set1.mSize > set2.mSize)
+            return false;
+
+        std::size_t j = 0;
+        for(std::size_t i = 0; i < set1.mChunks.size(); i++)
+        {
+            const Container& c = set1.mChunks[i];
+            while(j < set2.mChunks.size() && set2.mChunks[j].key < c.key)
+            {
+                j++;
+            }
+            if(j == set2.mChunks.size() || set2.mChunks[j].key != c.key || set2.mChunks[j].card < c.card ||
+               intersectCount(c, set2.mChunks[j], false) != c.card)
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Verifica se due set compressi non hanno elementi in comune.
+     *
+     * Termina al primo elemento comune.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return true se i set sono disgiunti.
+     * @return false altrimenti.
+     */
+    friend bool is_disjoint(const CompressedSet& set1, const CompressedSet& set2)
+    {
+        return countCommon(set1, set2, true) == 0;
+    }
+
+private:
+    // Ricerca binaria del primo blocco con chiave >= key
+    std::vector<Container>::iterator findChunk(std::uint16_t key)
+    {
+        return std::lower_bound(mChunks.begin(), mChunks.end(), key, keyLess);
+    }
+
+    std::vector<Container>::const_iterator findChunk(std::uint16_t key) const
+    {
+        return std::lower_bound(mChunks.begin(), mChunks.end(), key, keyLess);
+    }
+
+    static bool keyLess(const Container& c, std::uint16_t key)
+    {
+        return c.key < key;
+    }
+
+    static bool containerContains(const Container& c, std::uint16_t low)
+    {
+        if(c.type == ARRAY_CONTAINER)
+            return std::binary_search(c.values.begin(), c.values.end(), low);
+
+        if(c.type == BITMAP_CONTAINER)
+            return (c.words[low / 64] >> (low % 64)) & 1;
+
+        // Ricerca binaria dell'ultimo run con inizio <= low
+        std::size_t lo = 0, hi = c.values.size() / 2;
+        while(lo < hi)
+        {
+            std::size_t mid = (lo + hi) / 2;
+            if(c.values[2 * mid] <= low)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        return lo > 0 && low - c.values[2 * (lo - 1)] <= c.values[2 * (lo - 1) + 1];
+    }
+
+    // Imposta a 1 i bit [start, last] di una bitmap
+    static void setRange(std::vector<std::uint64_t>& words, std::uint32_t start, std::uint32_t last)
+    {
+        std::uint32_t first = start / 64, lastWord = last / 64;
+        std::uint64_t lowMask = ~std::uint64_t(0) << (start % 64);
+        std::uint64_t highMask = ~std::uint64_t(0) >> (63 - last % 64);
+
+        if(first == lastWord)
+        {
+            words[first] |= lowMask & highMask;
+            return;
+        }
+
+        words[first] |= lowMask;
+        for(std::uint32_t w = first + 1; w < lastWord; w++)
+        {
+            words[w] = ~std::uint64_t(0);
+        }
+        words[lastWord] |= highMask;
+    }
+
+    // Converte un contenitore qualunque nella sua bitmap
+    static void toBitmap(const Container& c, std::vector<std::uint64_t>& words)
+    {
+        if(c.type == BITMAP_CONTAINER)
+        {
+            words = c.words;
+            return;
+        }
+
+        words.assign(BITMAP_WORDS, 0);
+        if(c.type == ARRAY_CONTAINER)
+        {
+            for(std::size_t i = 0; i < c.values.size(); i++)
+            {
+                words[c.values[i] / 64] |= std::uint64_t(1) << (c.values[i] % 64);
+            }
+        }
+        else
+        {
+            for(std::size_t r = 0; r < c.values.size(); r += 2)
+            {
+                setRange(words, c.values[r], c.values[r] + static_cast<std::uint32_t>(c.values[r + 1]));
+            }
+        }
+    }
+
+    // Converte un contenitore qualunque nell'array ordinato dei suoi valori
+    static void toArray(const Container& c, std::vector<std::uint16_t>& values)
+    {
+        values.clear();
+        values.reserve(c.card);
+
+        if(c.type == ARRAY_CONTAINER)
+        {
+            values = c.values;
+        }
+        else if(c.type == RUN_CONTAINER)
+        {
+            for(std::size_t r = 0; r < c.values.size(); r += 2)
+            {
+                std::uint32_t last = c.values[r] + static_cast<std::uint32_t>(c.values[r + 1]);
+                for(std::uint32_t v = c.values[r]; v <= last; v++)
+                {
+                    values.push_back(static_cast<std::uint16_t>(v));
+                }
+            }
+        }
+        else
+        {
+            for(std::size_t w = 0; w < BITMAP_WORDS; w++)
+            {
+                for(std::uint64_t bits = c.words[w]; bits != 0; bits &= bits - 1)
+                {
+                    values.push_back(static_cast<std::uint16_t>(w * 64 + gset_detail::ctz64(bits)));
+                }
+            }
+        }
+    }
+
+    // Calcola le coppie (inizio, lunghezza - 1) dei valori del contenitore
+    static void buildRuns(const Container& c, std::vector<std::uint16_t>& runs)
+    {
+        if(c.type == RUN_CONTAINER)
+        {
+            runs = c.values;
+            return;
+        }
+
+        std::vector<std::uint16_t> values;
+        toArray(c, values);
+
+        runs.clear();
+        for(std::size_t i = 0; i < values.size(); )
+        {
+            std::size_t j = i;
+            while(j + 1 < values.size() && values[j + 1] == values[j] + 1)
+            {
+                j++;
+            }
+            runs.push_back(values[i]);
+            runs.push_back(static_cast<std::uint16_t>(j - i));
+            i = j + 1;
+        }
+    }
+
+    static void makeBitmap(Container& c)
+    {
+        std::vector<std::uint64_t> words;
+        toBitmap(c, words);
+        c.words.swap(words);
+        std::vector<std::uint16_t>().swap(c.values);
+        c.type = BITMAP_CONTAINER;
+    }
+
+    static void makeArray(Container& c)
+    {
+        std::vector<std::uint16_t> values;
+        toArray(c, values);
+        c.values.swap(values);
+        std::vector<std::uint64_t>().swap(c.words);
+        c.type = ARRAY_CONTAINER;
+    }
+
+    // Espande un run nella forma non compressa adatta alla sua cardinalità
+    static void expandRun(Container& c)
+    {
+        if(c.card <= ARRAY_MAX)
+            makeArray(c);
+        else
+            makeBitmap(c);
+    }
+
+    // Sceglie tra array e bitmap in base alla cardinalità
+    static void normalize(Container& c)
+    {
+        if(c.type == BITMAP_CONTAINER && c.card <= ARRAY_MAX)
+            makeArray(c);
+        else if(c.type == ARRAY_CONTAINER && c.card > ARRAY_MAX)
+            makeBitmap(c);
+    }
+
+    static std::uint32_t bitmapCardinality(const std::vector<std::uint64_t>& words)
+    {
+        std::uint32_t card = 0;
+        for(std::size_t w = 0; w < words.size(); w++)
+        {
+            card += gset_detail::popcount64(words[w]);
+        }
+        return card;
+    }
+
+    // Unione di due contenitori con la stessa chiave
+    static void unite(const Container& a, const Container& b, Container& res)
+    {
+        res.key = a.key;
+
+        if(a.type == ARRAY_CONTAINER && b.type == ARRAY_CONTAINER && a.card + b.card <= ARRAY_MAX)
+        {
+            res.type = ARRAY_CONTAINER;
+            res.values.reserve(a.card + b.card);
+            std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                           std::back_inserter(res.values));
+            res.card = static_cast<std::uint32_t>(res.values.size());
+            return;
+        }
+
+        res.type = BITMAP_CONTAINER;
+        toBitmap(a, res.words);
+        if(b.type == ARRAY_CONTAINER)
+        {
+            for(std::size_t i = 0; i < b.values.size(); i++)
+            {
+                res.words[b.values[i] / 64] |= std::uint64_t(1) << (b.values[i] % 64);
+            }
+        }
+        else if(b.type == RUN_CONTAINER)
+        {
+            for(std::size_t r = 0; r < b.values.size(); r += 2)
+            {
+                setRange(res.words, b.values[r], b.values[r] + static_cast<std::uint32_t>(b.values[r + 1]));
+            }
+        }
+        else
+        {
+            for(std::size_t w = 0; w < BITMAP_WORDS; w++)
+            {
+                res.words[w] |= b.words[w];
+            }
+        }
+
+        res.card = bitmapCardinality(res.words);
+        normalize(res);
+    }
+
+    // Intersezione di due contenitori con la stessa chiave
+    static void intersect(const Container& a, const Container& b, Container& res)
+    {
+        res.key = a.key;
+        res.type = ARRAY_CONTAINER;
+
+        if(a.type == ARRAY_CONTAINER && b.type == ARRAY_CONTAINER)
+        {
+            std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                  std::back_inserter(res.values));
+        }
+        else if(a.type == ARRAY_CONTAINER || b.type == ARRAY_CONTAINER)
+        {
+            const Container& arr = a.type == ARRAY_CONTAINER ? a : b;
+            const Container& other = a.type == ARRAY_CONTAINER ? b : a;
+            for(std::size_t i = 0; i < arr.values.size(); i++)
+            {
+                if(containerContains(other, arr.values[i]))
+                    res.values.push_back(arr.values[i]);
+            }
+        }
+        else
+        {
+            std::vector<std::uint64_t> other;
+            toBitmap(a, res.words);
+            toBitmap(b, other);
+            for(std::size_t w = 0; w < BITMAP_WORDS; w++)
+            {
+                res.words[w] &= other[w];
+            }
+            res.type = BITMAP_CONTAINER;
+            res.card = bitmapCardinality(res.words);
+            normalize(res);
+            return;
+        }
+
+        res.card = static_cast<std::uint32_t>(res.values.size());
+    }
+
+    // Numero di bit a 1 di una bitmap nell'intervallo [start, last]
+    static std::uint32_t rangeCardinality(const std::vector<std::uint64_t>& words, std::uint32_t start, std::uint32_t last)
+    {
+        std::uint32_t first = start / 64, lastWord = last / 64;
+        std::uint64_t lowMask = ~std::uint64_t(0) << (start % 64);
+        std::uint64_t highMask = ~std::uint64_t(0) >> (63 - last % 64);
+
+        if(first == lastWord)
+            return gset_detail::popcount64(words[first] & lowMask & highMask);
+
+        std::uint32_t card = gset_detail::popcount64(words[first] & lowMask);
+        for(std::uint32_t w = first + 1; w < lastWord; w++)
+        {
+            card += gset_detail::popcount64(words[w]);
+        }
+        return card + gset_detail::popcount64(words[lastWord] & highMask);
+    }
+
+    // Numero di valori comuni a due contenitori con la stessa chiave, senza allocare
+    static std::uint32_t intersectCount(const Container& a, const Container& b, bool stopAtFirst)
+    {
+        std::uint32_t count = 0;
+
+        if(a.type == BITMAP_CONTAINER && b.type == BITMAP_CONTAINER)
+        {
+            for(std::size_t w = 0; w < BITMAP_WORDS && !(stopAtFirst && count > 0); w++)
+            {
+                count += gset_detail::popcount64(a.words[w] & b.words[w]);
+            }
+            return count;
+        }
+
+        if(a.type == ARRAY_CONTAINER || b.type == ARRAY_CONTAINER)
+        {
+            // Ricerca dei valori dell'array più piccolo nell'altro contenitore
+            bool useA = a.type == ARRAY_CONTAINER && (b.type != ARRAY_CONTAINER || a.card <= b.card);
+            const Container& arr = useA ? a : b;
+            const Container& other = useA ? b : a;
+            for(std::size_t i = 0; i < arr.values.size() && !(stopAtFirst && count > 0); i++)
+            {
+                if(containerContains(other, arr.values[i]))
+                    count++;
+            }
+            return count;
+        }
+
+        const Container& run = a.type == RUN_CONTAINER ? a : b;
+        const Container& other = a.type == RUN_CONTAINER ? b : a;
+        if(other.type == BITMAP_CONTAINER)
+        {
+            for(std::size_t r = 0; r < run.values.size() && !(stopAtFirst && count > 0); r += 2)
+            {
+                count += rangeCardinality(other.words, run.values[r], run.values[r] + static_cast<std::uint32_t>(run.values[r + 1]));
+            }
+            return count;
+        }
+
+        // Sovrapposizione di due sequenze ordinate di run
+        std::size_t i = 0, j = 0;
+        while(i < run.values.size() && j < other.values.size() && !(stopAtFirst && count > 0))
+        {
+            std::uint32_t last1 = run.values[i] + static_cast<std::uint32_t>(run.values[i + 1]);
+            std::uint32_t last2 = other.values[j] + static_cast<std::uint32_t>(other.values[j + 1]);
+            std::uint32_t lo = std::max<std::uint32_t>(run.values[i], other.values[j]);
+            std::uint32_t hi = std::min(last1, last2);
+            if(lo <= hi)
+                count += hi - lo + 1;
+
+            if(last1 < last2)
+                i += 2;
+            else
+                j += 2;
+        }
+        return count;
+    }
+
+    // Conta i valori comuni dei contenitori con la stessa chiave (al più uno per contenitore se stopAtFirst)
+    static size_type countCommon(const CompressedSet& set1, const CompressedSet& set2, bool stopAtFirst)
+    {
+        size_type count = 0;
+
+        std::size_t i = 0, j = 0;
+        while(i < set1.mChunks.size() && j < set2.mChunks.size())
+        {
+            if(set1.mChunks[i].key < set2.mChunks[j].key)
+            {
+                i++;
+            }
+            else if(set2.mChunks[j].key < set1.mChunks[i].key)
+            {
+                j++;
+            }
+            else
+            {
+                count += intersectCount(set1.mChunks[i++], set2.mChunks[j++], stopAtFirst);
+                if(stopAtFirst && count > 0)
+                    break;
+            }
+        }
+
+        return count;
+    }
+
+    // Verifica la coerenza di un contenitore letto da uno stream
+    static bool isValid(const Container& c)
+    {
+        if(c.card == 0)
+            return false;
+
+        if(c.type == ARRAY_CONTAINER)
+        {
+            for(std::size_t i = 1; i < c.values.size(); i++)
+            {
+                if(c.values[i - 1] >= c.values[i])
+                    return false;
+            }
+            return true;
+        }
+
+        if(c.type == BITMAP_CONTAINER)
+            return c.card == bitmapCardinality(c.words);
+
+        // Run ordinati, disgiunti e interni al blocco
+        std::uint64_t card = 0;
+        std::uint32_t next = 0;
+        for(std::size_t r = 0; r < c.values.size(); r += 2)
+        {
+            std::uint32_t last = c.values[r] + static_cast<std::uint32_t>(c.values[r + 1]);
+            if((r > 0 && c.values[r] < next) || last > 0xFFFF)
+                return false;
+            card += c.values[r + 1] + 1u;
+            next = last + 1;
+        }
+        return card == c.card;
+    }
+
+    static void writeLE(std::ostream& out, std::uint64_t value, int bytes)
+    {
+        char buf[8];
+        for(int i = 0; i < bytes; i++)
+        {
+            buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        out.write(buf, bytes);
+    }
+
+    static std::uint64_t readLE(std::istream& in, int bytes)
+    {
+        unsigned char buf[8];
+        if(!in.read(reinterpret_cast<char*>(buf), bytes))
+            throw std::runtime_error("Formato del file non valido");
+
+        std::uint64_t value = 0;
+        for(int i = 0; i < bytes; i++)
+        {
+            value |= static_cast<std::uint64_t>(buf[i]) << (8 * i);
+        }
+        return value;
+    }
+
+private:
+    std::vector<Container> mChunks; //Contenitori ordinati per chiave
+    size_type mSize;                //Numero di elementi presenti
+};
+
+/**
+ * @brief Salva un set compresso su un file binario.
+ *
+ * @param set Set di input.
+ * @param path Percorso del file per salvare il set.
+ *
+ * @throw std::runtime_error se il file non può essere scritto.
+ */
+inline void save(const CompressedSet& set, const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Impossibile aprire il file per la scrittura");
+
+    set.serialize(file);
+    if(!file)
+        throw std::runtime_error("Impossibile scrivere il file");
+}
+
+/**
+ * @brief Carica un set compresso da un file scritto da save.
+ *
+ * @param set Set di destinazione (il contenuto precedente viene sostituito).
+ * @param path Percorso del file da leggere.
+ *
+ * @throw std::runtime_error se il file non può essere letto o non è valido.
+ */
+inline void load(CompressedSet& set, const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Impossibile aprire il file per la lettura");
+
+    set.deserialize(file);
+}
+
+#endif
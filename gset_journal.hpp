@@ -0,0 +1,454 @@
+/**
+ * @file gset_journal.hpp
+ *
+ * @brief file header della classe templata JournaledSet.
+ *
+ * Definizione e implementazione di un set di stringhe persistente
+ * tramite snapshot completo e registro incrementale delle modifiche (POSIX).
+ */
+
+#ifndef GSET_JOURNAL_HPP
+#define GSET_JOURNAL_HPP
+
+#if defined(_WIN32)
+#error "JournaledSet richiede un sistema POSIX (fsync)"
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gset.hpp"
+
+/**
+ * @brief Set di stringhe con persistenza incrementale.
+ *
+ * Lo stato persistente è composto da uno snapshot completo
+ * (path + ".snap", nel formato di save) e da un registro
+ * (path + ".log") in cui ogni add e remove riuscita accoda
+ * un record "+valore" o "-valore".
+ *
+ * I record vengono scritti a gruppi: commit() li accoda al registro
+ * con una sola write e una sola fsync, ed è chiamata automaticamente
+ * quando i record in attesa raggiungono groupSize. Il costo di scrittura
+ * dipende quindi dal numero di modifiche e non dalla dimensione del set.
+ *
+ * compact() scrive un nuovo snapshot in un thread separato: il registro
+ * corrente viene rinominato in path + ".log.old" e ne viene aperto uno nuovo,
+ * così che le modifiche successive possano proseguire nel frattempo.
+ * Al riavvio lo stato è ricostruito caricando lo snapshot e rieseguendo
+ * ".log.old" (se presente) e ".log"; le rinomine sono rese durevoli
+ * sincronizzando la directory che contiene i file.
+ *
+ * Come per save, i valori non possono contenere il carattere '\\n'.
+ *
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Hash Funzione di hash coerente con Equal, usata durante il ripristino.
+ */
+template<typename Equal, typename Hash = std::hash<std::string> >
+class JournaledSet
+{
+public:
+    typedef Set<std::string, Equal> set_type;
+    typedef typename set_type::size_type size_type;
+
+    /**
+     * @brief Apre il set persistente, ripristinandone lo stato.
+     *
+     * @param path Percorso base dei file di snapshot e registro.
+     * @param groupSize Numero di record che provoca un commit automatico.
+     *
+     * @throw std::runtime_error se i file non possono essere letti o scritti.
+     */
+    explicit JournaledSet(const std::string& path, std::size_t groupSize = 64)
+        : mSnapPath(path + ".snap"), mLogPath(path + ".log"), mOldLogPath(path + ".log.old"),
+          mFd(-1), mPending(0), mGroupSize(groupSize)
+    {
+        recover();
+        openLog();
+    }
+
+    /**
+     * @brief Distruttore.
+     *
+     * Esegue il commit dei record in attesa e attende
+     * la fine di un'eventuale compattazione.
+     */
+    ~JournaledSet()
+    {
+        try
+        {
+            commit();
+        }
+        catch(...)
+        {
+        }
+        if(mCompactor.joinable())
+            mCompactor.join();
+        if(mFd >= 0)
+            ::close(mFd);
+    }
+
+    /**
+     * @brief Aggiunge un elemento al set e ne registra l'aggiunta.
+     *
+     * @param value Valore da aggiungere.
+     * @return true Se l'elemento è stato aggiunto con successo.
+     * @return false Se l'elemento è già presente nel set.
+     */
+    bool add(const std::string& value)
+    {
+        if(!mSet.add(value))
+            return false;
+
+        append('+', value);
+        return true;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set e ne registra la rimozione.
+     *
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(const std::string& value)
+    {
+        if(!mSet.remove(value))
+            return false;
+
+        append('-', value);
+        return true;
+    }
+
+    bool contains(const std::string& value) const { return mSet.contains(value); }
+    size_type getSize() const { return mSet.getSize(); }
+
+    /**
+     * @brief Set corrente (in sola lettura).
+     */
+    const set_type& getSet() const { return mSet; }
+
+    /**
+     * @brief Rende durevoli i record in attesa.
+     *
+     * @throw std::runtime_error in caso di errore di scrittura.
+     */
+    void commit()
+    {
+        if(mPending == 0)
+            return;
+
+        writeAll(mFd, mBuffer);
+        if(::fsync(mFd) != 0)
+            throw std::runtime_error(std::string("Impossibile sincronizzare il registro: ") + std::strerror(errno));
+
+        mBuffer.clear();
+        mPending = 0;
+    }
+
+    /**
+     * @brief Avvia la compattazione del registro in un nuovo snapshot.
+     *
+     * Attende l'eventuale compattazione precedente, ruota il registro
+     * e scrive lo snapshot di una copia del set in un thread separato.
+     * Se una compattazione precedente è fallita, il registro corrente
+     * viene accodato a ".log.old", che non è ancora coperto da uno snapshot.
+     *
+     * @throw std::runtime_error se la compattazione precedente è fallita
+     * o il registro non può essere ruotato.
+     */
+    void compact()
+    {
+        waitCompaction();
+        commit();
+
+        ::close(mFd);
+        mFd = -1;
+        if(std::ifstream(mOldLogPath).good())
+        {
+            appendFile(mLogPath, mOldLogPath);
+            if(::truncate(mLogPath.c_str(), 0) != 0)
+                throw std::runtime_error("Impossibile troncare il registro " + mLogPath);
+        }
+        else if(std::rename(mLogPath.c_str(), mOldLogPath.c_str()) != 0)
+        {
+            throw std::runtime_error("Impossibile ruotare il registro");
+        }
+        syncDirectory(mLogPath);
+        openLog();
+
+        set_type copy(mSet);
+        mCompactor = std::thread(&JournaledSet::runCompaction, this, std::move(copy));
+    }
+
+    /**
+     * @brief Attende la fine della compattazione in corso.
+     *
+     * @throw L'eccezione sollevata dalla compattazione, se fallita.
+     */
+    void waitCompaction()
+    {
+        if(mCompactor.joinable())
+            mCompactor.join();
+
+        if(mCompactError)
+        {
+            std::exception_ptr error = mCompactError;
+            mCompactError = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    JournaledSet(const JournaledSet&);
+    JournaledSet& operator=(const JournaledSet&);
+
+    // Accoda un record al buffer del prossimo commit
+    void append(char op, const std::string& value)
+    {
+        mBuffer += op;
+        mBuffer += value;
+        mBuffer += '\n';
+        mPending++;
+
+        if(mPending >= mGroupSize)
+            commit();
+    }
+
+    /**
+     * @brief Stato ricostruito durante il ripristino.
+     *
+     * Gli elementi sono mantenuti in ordine di inserimento con un indice
+     * di hash, così che ogni record sia applicato in tempo costante.
+     */
+    struct Recovery
+    {
+        std::vector<std::string> values;                                //Elementi in ordine di inserimento
+        std::vector<bool> live;                                         //Elementi non rimossi
+        std::unordered_map<std::string, std::size_t, Hash, Equal> index; //Posizione dell'ultima aggiunta
+
+        void add(const std::string& value)
+        {
+            typename std::unordered_map<std::string, std::size_t, Hash, Equal>::iterator it = index.find(value);
+            if(it == index.end())
+                index.insert(std::make_pair(value, values.size()));
+            else if(live[it->second])
+                return;
+            else
+                it->second = values.size(); //Riaggiunto dopo una rimozione: va in coda
+
+            values.push_back(value);
+            live.push_back(true);
+        }
+
+        void remove(const std::string& value)
+        {
+            typename std::unordered_map<std::string, std::size_t, Hash, Equal>::iterator it = index.find(value);
+            if(it != index.end())
+                live[it->second] = false;
+        }
+    };
+
+    // Ricostruisce il set da snapshot e registri
+    void recover()
+    {
+        Recovery state;
+        std::ifstream snap(mSnapPath);
+        std::string line;
+        while(std::getline(snap, line))
+        {
+            state.add(line);
+        }
+        snap.close();
+
+        bool leftover = std::ifstream(mOldLogPath).good();
+        if(leftover)
+            replay(mOldLogPath, state);
+        replay(mLogPath, state);
+
+        std::size_t kept = 0;
+        for(std::size_t i = 0; i < state.values.size(); i++)
+        {
+            if(state.live[i])
+                state.values[kept++].swap(state.values[i]);
+        }
+        mSet = set_type(assume_unique, state.values.begin(), state.values.begin() + kept);
+
+        if(leftover)
+        {
+            // Compattazione interrotta: consolida subito lo stato ricostruito
+            writeSnapshot(mSet, mSnapPath);
+            std::remove(mOldLogPath.c_str());
+            std::ofstream(mLogPath.c_str(), std::ios::trunc);
+        }
+    }
+
+    // Riesegue un registro, scartando un eventuale record finale incompleto
+    void replay(const std::string& path, Recovery& state)
+    {
+        std::ifstream log(path);
+        if(!log)
+            return;
+
+        std::string line;
+        long long good = 0;
+        while(std::getline(log, line))
+        {
+            if(log.eof())
+                break; //Record non terminato da '\n': scrittura interrotta
+
+            if(!line.empty() && line[0] == '+')
+                state.add(line.substr(1));
+            else if(!line.empty() && line[0] == '-')
+                state.remove(line.substr(1));
+            good += static_cast<long long>(line.size()) + 1;
+        }
+        log.close();
+
+        if(::truncate(path.c_str(), static_cast<off_t>(good)) != 0)
+            throw std::runtime_error("Impossibile troncare il registro " + path);
+    }
+
+    void openLog()
+    {
+        mFd = ::open(mLogPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if(mFd < 0)
+            throw std::runtime_error("Impossibile aprire il registro " + mLogPath);
+    }
+
+    // Corpo del thread di compattazione
+    void runCompaction(set_type copy)
+    {
+        try
+        {
+            writeSnapshot(copy, mSnapPath);
+            std::remove(mOldLogPath.c_str());
+        }
+        catch(...)
+        {
+            mCompactError = std::current_exception();
+        }
+    }
+
+    // Scrive uno snapshot su un file temporaneo e lo sostituisce atomicamente
+    static void writeSnapshot(const set_type& set, const std::string& path)
+    {
+        std::string tmp = path + ".tmp";
+        save(set, tmp);
+
+        int fd = ::open(tmp.c_str(), O_RDONLY);
+        if(fd < 0 || ::fsync(fd) != 0)
+        {
+            if(fd >= 0)
+                ::close(fd);
+            throw std::runtime_error("Impossibile sincronizzare lo snapshot");
+        }
+        ::close(fd);
+
+        if(std::rename(tmp.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("Impossibile sostituire lo snapshot");
+        syncDirectory(path);
+    }
+
+    // Rende durevoli le rinomine e le rimozioni nella directory di path
+    static void syncDirectory(const std::string& path)
+    {
+        std::string::size_type slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if(fd < 0 || ::fsync(fd) != 0)
+        {
+            if(fd >= 0)
+                ::close(fd);
+            throw std::runtime_error("Impossibile sincronizzare la directory " + dir);
+        }
+        ::close(fd);
+    }
+
+    // Accoda il contenuto di from a to e lo rende durevole
+    static void appendFile(const std::string& from, const std::string& to)
+    {
+        int in = ::open(from.c_str(), O_RDONLY);
+        if(in < 0)
+            throw std::runtime_error("Impossibile aprire il registro " + from);
+        int out = ::open(to.c_str(), O_WRONLY | O_APPEND);
+        if(out < 0)
+        {
+            ::close(in);
+            throw std::runtime_error("Impossibile aprire il registro " + to);
+        }
+
+        try
+        {
+            std::string block(1 << 16, '\0');
+            for(;;)
+            {
+                ssize_t n = ::read(in, &block[0], block.size());
+                if(n < 0 && errno == EINTR)
+                    continue;
+                if(n < 0)
+                    throw std::runtime_error(std::string("Impossibile leggere il registro: ") + std::strerror(errno));
+                if(n == 0)
+                    break;
+                writeAll(out, block.substr(0, static_cast<std::size_t>(n)));
+            }
+            if(::fsync(out) != 0)
+                throw std::runtime_error(std::string("Impossibile sincronizzare il registro: ") + std::strerror(errno));
+        }
+        catch(...)
+        {
+            ::close(in);
+            ::close(out);
+            throw;
+        }
+        ::close(in);
+        ::close(out);
+    }
+
+    static void writeAll(int fd, const std::string& data)
+    {
+        const char* p = data.data();
+        std::size_t left = data.size();
+        while(left > 0)
+        {
+            ssize_t n = ::write(fd, p, left);
+            if(n < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                throw std::runtime_error(std::string("Impossibile scrivere il registro: ") + std::strerror(errno));
+            }
+            p += n;
+            left -= static_cast<std::size_t>(n);
+        }
+    }
+
+private:
+    set_type mSet;                      //Stato corrente
+    std::string mSnapPath;              //File dello snapshot
+    std::string mLogPath;               //Registro corrente
+    std::string mOldLogPath;            //Registro in corso di compattazione
+    int mFd;                            //Descrittore del registro corrente
+    std::string mBuffer;                //Record in attesa di commit
+    std::size_t mPending;               //Numero di record in attesa
+    std::size_t mGroupSize;             //Soglia di commit automatico
+    std::thread mCompactor;             //Thread di compattazione
+    std::exception_ptr mCompactError;   //Errore dell'ultima compattazione
+};
+
+#endif
@@ -0,0 +1,393 @@
+/**
+ * @file gset_mmap.hpp
+ *
+ * @brief file header della classe templata MappedSet.
+ *
+ * Definizione e implementazione di un set generico persistente,
+ * i cui elementi risiedono in un file mappato in memoria (POSIX).
+ */
+
+#ifndef GSET_MMAP_HPP
+#define GSET_MMAP_HPP
+
+#if defined(_WIN32)
+#error "MappedSet richiede un sistema POSIX (mmap)"
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Classe MappedSet generica.
+ *
+ * La classe implementa un set di oggetti T memorizzato direttamente
+ * in un file mappato in memoria. Il file contiene un'intestazione
+ * di dimensione fissa seguita dall'array degli elementi, con lo stesso
+ * layout usato in memoria: la riapertura non richiede alcuna lettura
+ * e le pagine vengono caricate solo quando accedute.
+ *
+ * Un file può essere aperto da un solo MappedSet alla volta (un solo
+ * scrittore): l'apertura acquisisce un lock esclusivo con flock,
+ * mantenuto fino alla distruzione, perché la crescita del file
+ * rimappa l'array. Le modifiche sono garantite su disco solo dopo sync().
+ * Il file non è portabile tra architetture diverse (endianness,
+ * dimensione e allineamento di T).
+ *
+ * @tparam T Tipo degli elementi nel set (deve essere trivially copyable).
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ */
+template<typename T, typename Equal>
+class MappedSet
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MappedSet richiede un tipo trivially copyable");
+
+public:
+    typedef std::uint64_t size_type;
+    typedef const T* const_iterator;
+
+    /**
+     * @brief Apre (o crea) il set associato a un file.
+     *
+     * @param path Percorso del file.
+     *
+     * @throw std::runtime_error se il file non può essere aperto,
+     * è già aperto da un altro MappedSet, non può essere mappato
+     * o non contiene un set compatibile con T.
+     */
+    explicit MappedSet(const std::string& path) : mFd(-1), mMap(nullptr), mMapBytes(0)
+    {
+        mFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if(mFd < 0)
+            throw std::runtime_error("Impossibile aprire il file " + path);
+
+        try
+        {
+            if(::flock(mFd, LOCK_EX | LOCK_NB) != 0)
+                throw std::runtime_error("File già aperto da un altro MappedSet: " + path);
+
+            struct stat st;
+            if(::fstat(mFd, &st) != 0)
+                throw std::runtime_error("Impossibile leggere la dimensione del file " + path);
+
+            if(st.st_size == 0)
+            {
+                mapFile(DATA_OFFSET);
+
+                Header* h = header();
+                std::memcpy(h->magic, MAGIC, sizeof(h->magic));
+                h->version = VERSION;
+                h->elemSize = sizeof(T);
+                h->size = 0;
+                h->capacity = 0;
+            }
+            else
+            {
+                if(static_cast<std::uint64_t>(st.st_size) < DATA_OFFSET)
+                    throw std::runtime_error("Formato del file non valido");
+
+                mapFile(static_cast<std::size_t>(st.st_size));
+
+                const Header* h = header();
+                if(std::memcmp(h->magic, MAGIC, sizeof(h->magic)) != 0 || h->version != VERSION ||
+                   h->elemSize != sizeof(T) || h->size > h->capacity ||
+                   h->capacity > (static_cast<std::uint64_t>(st.st_size) - DATA_OFFSET) / sizeof(T))
+                    throw std::runtime_error("Formato del file non valido");
+            }
+        }
+        catch(...)
+        {
+            close();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Distruttore.
+     *
+     * Rilascia la mappatura senza forzare la scrittura su disco:
+     * per la durabilità è necessario chiamare sync().
+     */
+    ~MappedSet()
+    {
+        close();
+    }
+
+    /**
+     * @brief Aggiunge un elemento al set.
+     *
+     * Nel caso in cui il file non abbia spazio sufficiente
+     * viene esteso secondo lo stesso fattore di crescita di Set.
+     *
+     * @param value Valore da aggiungere.
+     * @return true Se l'elemento è stato aggiunto con successo.
+     * @return false Se l'elemento è già presente nel set.
+     *
+     * @throw std::runtime_error se il file non può essere esteso.
+     */
+    bool add(const T& value)
+    {
+        if(contains(value))
+            return false; //Elemento già presente
+
+        Header* h = header();
+        if(h->size == h->capacity)
+        {
+            grow(h->capacity == 0 ? 2 : h->capacity + h->capacity / 2);
+            h = header();
+        }
+
+        data()[h->size] = value;
+        h->size++;
+        return true;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set.
+     *
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(const T& value)
+    {
+        Header* h = header();
+        T* d = data();
+        for(size_type i = 0; i < h->size; i++)
+        {
+            if(mEq(d[i], value))
+            {
+                std::memmove(d + i, d + i + 1, (h->size - i - 1) * sizeof(T));
+                h->size--;
+                return true;
+            }
+        }
+
+        return false; //Elemento assente
+    }
+
+    /**
+     * @brief Verifica se un elemento è presente nel set.
+     *
+     * @param value Valore da cercare.
+     * @return true se l'elemento è presente.
+     * @return false se l'elemento non è presente.
+     */
+    bool contains(const T& value) const
+    {
+        const T* d = data();
+        for(size_type i = 0; i < getSize(); i++)
+        {
+            if(mEq(d[i], value))
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Svuota il set.
+     *
+     * Il file viene riportato alla sola intestazione.
+     *
+     * @throw std::runtime_error se il file non può essere ridimensionato.
+     */
+    void empty()
+    {
+        header()->size = 0;
+        header()->capacity = 0;
+        remap(DATA_OFFSET);
+    }
+
+    /**
+     * @brief Scrive su disco le modifiche effettuate.
+     *
+     * @throw std::runtime_error in caso di errore di scrittura.
+     */
+    void sync()
+    {
+        if(::msync(mMap, mMapBytes, MS_SYNC) != 0 || ::fsync(mFd) != 0)
+            throw std::runtime_error(std::string("Impossibile sincronizzare il file: ") + std::strerror(errno));
+    }
+
+    /**
+     * @brief Operatore di accesso agli elementi del set.
+     *
+     * @param index Indice dell'elemento.
+     * @return T elemento.
+     *
+     * @throw std::out_of_range se l'indice è fuori dai limit.
+     */
+    T operator[](size_type index) const
+    {
+        if(index >= getSize())
+            throw std::out_of_range("index out of bounds"); //index out of bounds
+        return data()[index];
+    }
+
+    /**
+     * @brief Operatore di stream per la stampa del set.
+     *
+     * @param out Stream di output.
+     * @param set Set da stampare.
+     * @return std::ostream& Stream di output.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const MappedSet& set)
+    {
+        out << set.getSize();
+        for(const_iterator i = set.begin(); i != set.end(); ++i)
+        {
+            out << " (" << *i << ")";
+        }
+
+        return out;
+    }
+
+    size_type getSize() const { return header()->size; }
+    size_type getCapacity() const { return header()->capacity; }
+
+	/**
+     * @brief Ritorna l'iteratore all'inizio della sequenza dati.
+     *
+     * @return const_iterator Iteratore all'inizio della sequenza dati.
+     */
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+	/**
+     * @brief Ritorna l'iteratore alla fine della sequenza dati.
+     *
+     * @return const_iterator Iteratore alla fine della sequenza dati.
+     */
+    const_iterator end() const
+    {
+        return data() + getSize();
+    }
+
+private:
+    MappedSet(const MappedSet&) = delete;
+    MappedSet& operator=(const MappedSet&) = delete;
+
+    /**
+     * @brief Intestazione del file.
+     */
+    struct Header
+    {
+        char magic[8];          //Identificativo del formato
+        std::uint32_t version;  //Versione del formato
+        std::uint32_t elemSize; //sizeof(T) al momento della creazione
+        std::uint64_t size;     //Numero di elementi presenti
+        std::uint64_t capacity; //Numero di elementi inseribili
+    };
+
+    static const std::uint32_t VERSION = 1;
+    static const std::size_t DATA_OFFSET = 64; //Inizio dell'array, allineato alla linea di cache
+    static const char MAGIC[8];
+
+    Header* header() { return static_cast<Header*>(mMap); }
+    const Header* header() const { return static_cast<const Header*>(mMap); }
+
+    T* data() { return reinterpret_cast<T*>(static_cast<char*>(mMap) + DATA_OFFSET); }
+    const T* data() const { return reinterpret_cast<const T*>(static_cast<const char*>(mMap) + DATA_OFFSET); }
+
+    /**
+     * @brief Ridimensiona il file e lo mappa.
+     *
+     * @param bytes Nuova dimensione del file.
+     */
+    void mapFile(std::size_t bytes)
+    {
+        if(::ftruncate(mFd, static_cast<off_t>(bytes)) != 0)
+            throw std::runtime_error(std::string("Impossibile ridimensionare il file: ") + std::strerror(errno));
+
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+        if(map == MAP_FAILED)
+            throw std::runtime_error(std::string("Impossibile mappare il file: ") + std::strerror(errno));
+
+        mMap = map;
+        mMapBytes = bytes;
+    }
+
+    /**
+     * @brief Sostituisce la mappatura corrente con una di dimensione bytes.
+     *
+     * La nuova mappatura viene creata prima di rilasciare quella corrente:
+     * se il file non può essere esteso o mappato il set resta invariato e utilizzabile.
+     */
+    void remap(std::size_t bytes)
+    {
+        bool growing = bytes > mMapBytes;
+        if(growing && ::ftruncate(mFd, static_cast<off_t>(bytes)) != 0)
+            throw std::runtime_error(std::string("Impossibile ridimensionare il file: ") + std::strerror(errno));
+
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+        if(map == MAP_FAILED)
+        {
+            int error = errno;
+            if(growing)
+            {
+                int restored = ::ftruncate(mFd, static_cast<off_t>(mMapBytes)); //Ripristino non essenziale
+                (void)restored;
+            }
+            throw std::runtime_error(std::string("Impossibile mappare il file: ") + std::strerror(error));
+        }
+
+        ::munmap(mMap, mMapBytes);
+        mMap = map;
+        mMapBytes = bytes;
+
+        // Riduzione del file solo dopo aver rilasciato la mappatura più grande
+        if(!growing && ::ftruncate(mFd, static_cast<off_t>(bytes)) != 0)
+            throw std::runtime_error(std::string("Impossibile ridimensionare il file: ") + std::strerror(errno));
+    }
+
+    /**
+     * @brief Estende il file per ospitare newCapacity elementi.
+     *
+     * @param newCapacity Nuova capacità.
+     */
+    void grow(size_type newCapacity)
+    {
+        remap(static_cast<std::size_t>(DATA_OFFSET + newCapacity * sizeof(T)));
+        header()->capacity = newCapacity;
+    }
+
+    void close()
+    {
+        if(mMap != nullptr)
+        {
+            ::munmap(mMap, mMapBytes);
+            mMap = nullptr;
+        }
+        if(mFd >= 0)
+        {
+            ::close(mFd);
+            mFd = -1;
+        }
+    }
+
+private:
+    int mFd;                //Descrittore del file
+    void* mMap;             //Inizio della mappatura
+    std::size_t mMapBytes;  //Dimensione della mappatura
+    Equal mEq;              //Funtore per confronto elementi
+};
+
+template<typename T, typename Equal>
+const char MappedSet<T, Equal>::MAGIC[8] = {'G', 'S', 'E', 'T', 'M', 'A', 'P', '\0'};
+
+#endif
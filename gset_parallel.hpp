@@ -0,0 +1,329 @@
+/**
+ * @file gset_parallel.hpp
+ *
+ * @brief file header degli algoritmi paralleli sugli elementi di un Set.
+ *
+ * Definizione e implementazione di parallel_for_each e parallel_reduce,
+ * che suddividono l'array degli elementi in blocchi allineati alle
+ * linee di cache e li distribuiscono tra thread con work stealing.
+ */
+
+#ifndef GSET_PARALLEL_HPP
+#define GSET_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gset.hpp"
+
+namespace gset_detail
+{
+    const std::size_t CACHE_LINE = 64;          //Dimensione di una linea di cache
+    const std::size_t MIN_PARALLEL_SLOTS = 4096; //Sotto questa soglia si procede in sequenza
+
+    /**
+     * @brief Esegue body(c) per ogni blocco c in [0, chunks) con work stealing.
+     *
+     * Ogni thread riceve inizialmente un intervallo contiguo di blocchi
+     * e li consuma dalla testa della propria coda; quando la coda è vuota
+     * ruba blocchi dalla coda degli altri thread. Il thread chiamante
+     * partecipa come uno dei worker.
+     * La prima eccezione sollevata da body interrompe l'esecuzione
+     * e viene rilanciata al chiamante.
+     *
+     * @param chunks Numero di blocchi.
+     * @param threads Numero di thread (>= 1).
+     * @param body Funzione da eseguire per ogni blocco.
+     */
+    template<typename Body>
+    void run_work_stealing(std::size_t chunks, unsigned threads, Body body)
+    {
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<std::size_t> tasks;
+        };
+
+        std::vector<Queue> queues(threads);
+        for(unsigned t = 0; t < threads; t++)
+        {
+            std::size_t from = chunks * t / threads;
+            std::size_t to = chunks * (t + 1) / threads;
+            for(std::size_t c = from; c < to; c++)
+            {
+                queues[t].tasks.push_back(c);
+            }
+        }
+
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        auto worker = [&](unsigned self)
+        {
+            for(;;)
+            {
+                if(failed.load(std::memory_order_relaxed))
+                    return;
+
+                bool found = false;
+                std::size_t task = 0;
+                {
+                    std::lock_guard<std::mutex> guard(queues[self].lock);
+                    if(!queues[self].tasks.empty())
+                    {
+                        task = queues[self].tasks.front();
+                        queues[self].tasks.pop_front();
+                        found = true;
+                    }
+                }
+
+                for(unsigned v = 1; v < threads && !found; v++)
+                {
+                    Queue& victim = queues[(self + v) % threads];
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    if(!victim.tasks.empty())
+                    {
+                        task = victim.tasks.back();
+                        victim.tasks.pop_back();
+                        found = true;
+                    }
+                }
+
+                // Nessun nuovo blocco viene generato: se tutte le code sono vuote il lavoro è finito
+                if(!found)
+                    return;
+
+                try
+                {
+                    body(task);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> guard(errorLock);
+                    if(!error)
+                        error = std::current_exception();
+                    failed.store(true);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        try
+        {
+            for(unsigned t = 1; t < threads; t++)
+            {
+                pool.push_back(std::thread(worker, t));
+            }
+        }
+        catch(...)
+        {
+            // Creazione di un thread fallita: i thread avviati esauriscono le code
+            for(std::size_t t = 0; t < pool.size(); t++)
+            {
+                pool[t].join();
+            }
+            throw;
+        }
+        worker(0);
+        for(std::size_t t = 0; t < pool.size(); t++)
+        {
+            pool[t].join();
+        }
+
+        if(error)
+            std::rethrow_exception(error);
+    }
+
+    /**
+     * @brief Suddivisione dell'array degli slot in blocchi.
+     *
+     * I confini interni dei blocchi cadono su inizi di linea di cache,
+     * così che due thread non accedano mai alla stessa linea.
+     */
+    template<typename T>
+    struct ChunkPlan
+    {
+        ChunkPlan(const T* data, std::size_t slots, unsigned threads, std::size_t grain)
+        {
+            std::size_t perLine = std::max<std::size_t>(1, CACHE_LINE / sizeof(T));
+
+            if(grain == 0)
+                grain = std::max<std::size_t>(1024, slots / (threads * 8 + 1));
+            size = (grain + perLine - 1) / perLine * perLine;
+
+            // Slot che precedono il primo confine di linea di cache
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(data);
+            head = 0;
+            if(CACHE_LINE % sizeof(T) == 0 && addr % sizeof(T) == 0)
+                head = std::min(slots, ((CACHE_LINE - addr % CACHE_LINE) % CACHE_LINE) / sizeof(T));
+
+            total = slots;
+            count = (head > 0 ? 1 : 0) + (slots - head + size - 1) / size;
+        }
+
+        std::size_t begin(std::size_t c) const
+        {
+            if(head == 0)
+                return c * size;
+            return c == 0 ? 0 : head + (c - 1) * size;
+        }
+
+        std::size_t end(std::size_t c) const
+        {
+            return std::min(total, head == 0 ? (c + 1) * size : (c == 0 ? head : head + c * size));
+        }
+
+        std::size_t head;   //Lunghezza del blocco iniziale non allineato
+        std::size_t size;   //Lunghezza dei blocchi allineati
+        std::size_t total;  //Numero di slot
+        std::size_t count;  //Numero di blocchi
+    };
+
+    /**
+     * @brief Risultato parziale di un blocco.
+     *
+     * Evita std::vector<bool>, i cui elementi non possono
+     * essere scritti in modo indipendente da thread diversi.
+     */
+    template<typename R>
+    struct Partial
+    {
+        R value;
+    };
+
+    inline unsigned resolve_threads(unsigned threads)
+    {
+        return threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    }
+}
+
+/**
+ * @brief Applica una funzione a ogni elemento del set, in parallelo.
+ *
+ * Funzione GLOBALE che suddivide l'array contiguo degli elementi
+ * in blocchi allineati alle linee di cache e li distribuisce tra
+ * i thread con work stealing. f viene chiamata concorrentemente
+ * da più thread e deve quindi essere thread-safe; l'ordine delle
+ * chiamate non è specificato. Il set non deve essere modificato
+ * durante l'esecuzione.
+ *
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Size Tipo delle dimensioni del set.
+ * @tparam F Funzione chiamata come f(const T&).
+ * @param set Set di input.
+ * @param f Funzione da applicare.
+ * @param threads Numero di thread (0 = numero di core disponibili).
+ * @param grain Numero minimo di elementi per blocco (0 = automatico).
+ *
+ * @throw La prima eccezione sollevata da f.
+ */
+template<typename T, typename Equal, typename Size, typename F>
+void parallel_for_each(const Set<T, Equal, Size>& set, F f, unsigned threads = 0, std::size_t grain = 0)
+{
+    typedef gset_detail::SlotAccess<Set<T, Equal, Size> > access;
+    const T* data = access::data(set);
+    const bool* dead = access::dead(set);
+    std::size_t slots = access::slots(set);
+
+    threads = gset_detail::resolve_threads(threads);
+    if(threads == 1 || slots < gset_detail::MIN_PARALLEL_SLOTS)
+    {
+        for(std::size_t i = 0; i < slots; i++)
+        {
+            if(dead == nullptr || !dead[i])
+                f(data[i]);
+        }
+        return;
+    }
+
+    gset_detail::ChunkPlan<T> plan(data, slots, threads, grain);
+    gset_detail::run_work_stealing(plan.count, threads, [&](std::size_t c)
+    {
+        for(std::size_t i = plan.begin(c), e = plan.end(c); i < e; i++)
+        {
+            if(dead == nullptr || !dead[i])
+                f(data[i]);
+        }
+    });
+}
+
+/**
+ * @brief Riduzione parallela degli elementi del set.
+ *
+ * Funzione GLOBALE che calcola reduce(... reduce(identity, map(e1)) ..., map(eN))
+ * suddividendo gli elementi in blocchi come parallel_for_each.
+ * Ogni blocco produce un risultato parziale; i parziali vengono
+ * combinati nell'ordine dei blocchi, per cui il risultato è
+ * deterministico se reduce è associativa e identity è il suo
+ * elemento neutro.
+ *
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Size Tipo delle dimensioni del set.
+ * @tparam R Tipo del risultato.
+ * @tparam Map Funzione chiamata come map(const T&), con risultato convertibile in R.
+ * @tparam Reduce Funzione associativa chiamata come reduce(R, R).
+ * @param set Set di input.
+ * @param identity Elemento neutro di reduce.
+ * @param map Trasformazione applicata a ogni elemento.
+ * @param reduce Operazione di combinazione.
+ * @param threads Numero di thread (0 = numero di core disponibili).
+ * @param grain Numero minimo di elementi per blocco (0 = automatico).
+ * @return R Risultato della riduzione.
+ *
+ * @throw La prima eccezione sollevata da map o reduce.
+ */
+template<typename T, typename Equal, typename Size, typename R, typename Map, typename Reduce>
+R parallel_reduce(const Set<T, Equal, Size>& set, R identity, Map map, Reduce reduce,
+                  unsigned threads = 0, std::size_t grain = 0)
+{
+    typedef gset_detail::SlotAccess<Set<T, Equal, Size> > access;
+    const T* data = access::data(set);
+    const bool* dead = access::dead(set);
+    std::size_t slots = access::slots(set);
+
+    threads = gset_detail::resolve_threads(threads);
+    if(threads == 1 || slots < gset_detail::MIN_PARALLEL_SLOTS)
+    {
+        R acc = identity;
+        for(std::size_t i = 0; i < slots; i++)
+        {
+            if(dead == nullptr || !dead[i])
+                acc = reduce(acc, map(data[i]));
+        }
+        return acc;
+    }
+
+    gset_detail::ChunkPlan<T> plan(data, slots, threads, grain);
+    gset_detail::Partial<R> init = { identity };
+    std::vector<gset_detail::Partial<R> > partials(plan.count, init);
+    gset_detail::run_work_stealing(plan.count, threads, [&](std::size_t c)
+    {
+        R acc = identity;
+        for(std::size_t i = plan.begin(c), e = plan.end(c); i < e; i++)
+        {
+            if(dead == nullptr || !dead[i])
+                acc = reduce(acc, map(data[i]));
+        }
+        partials[c].value = acc;
+    });
+
+    R acc = identity;
+    for(std::size_t c = 0; c < partials.size(); c++)
+    {
+        acc = reduce(acc, partials[c].value);
+    }
+    return acc;
+}
+
+#endif
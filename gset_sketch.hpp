@@ -0,0 +1,418 @@
+/**
+ * @file gset_sketch.hpp
+ *
+ * @brief file header degli sketch probabilistici HyperLogLog e MinHash.
+ *
+ * Definizione e implementazione di strutture di dimensione fissa
+ * per stimare cardinalità, unione, intersezione e similarità di Jaccard
+ * tra set senza calcolarli esplicitamente.
+ */
+
+#ifndef GSET_SKETCH_HPP
+#define GSET_SKETCH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "gset_bits.hpp"
+
+namespace gset_detail
+{
+    /**
+     * @brief Rimescola i bit di un hash (finalizzatore di splitmix64).
+     *
+     * Necessario perché funzioni di hash come std::hash<int>
+     * possono essere l'identità.
+     */
+    inline std::uint64_t mix64(std::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+/**
+ * @brief Sketch HyperLogLog per la stima della cardinalità.
+ *
+ * Occupa 2^precision byte indipendentemente dal numero di elementi;
+ * l'errore relativo tipico è 1.04 / sqrt(2^precision)
+ * (circa 0.8% con la precisione di default).
+ * Due sketch con la stessa precisione possono essere fusi
+ * per ottenere lo sketch dell'unione.
+ *
+ * @tparam T Tipo degli elementi.
+ * @tparam Hash Funzione di hash, coerente con l'uguaglianza del set.
+ */
+template<typename T, typename Hash = std::hash<T> >
+class HyperLogLog
+{
+public:
+    /**
+     * @brief Costruttore di uno sketch vuoto.
+     *
+     * @param precision Numero di bit dell'hash usati per scegliere il registro (4-18).
+     * @param hash Funzione di hash.
+     *
+     * @throw std::invalid_argument se la precisione è fuori dall'intervallo.
+     */
+    explicit HyperLogLog(unsigned precision = 14, const Hash& hash = Hash())
+        : mPrecision(precision), mHash(hash)
+    {
+        if(precision < 4 || precision > 18)
+            throw std::invalid_argument("precisione non valida");
+        mRegisters.assign(std::size_t(1) << precision, 0);
+    }
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     * @param precision Numero di bit dell'hash usati per scegliere il registro.
+     * @param hash Funzione di hash.
+     */
+    template<typename Iter>
+    HyperLogLog(Iter begin, Iter end, unsigned precision = 14, const Hash& hash = Hash())
+        : mPrecision(precision), mHash(hash)
+    {
+        if(precision < 4 || precision > 18)
+            throw std::invalid_argument("precisione non valida");
+        mRegisters.assign(std::size_t(1) << precision, 0);
+        for(; begin != end; ++begin)
+        {
+            add(*begin);
+        }
+    }
+
+    /**
+     * @brief Registra un elemento.
+     *
+     * @param value Elemento da registrare.
+     */
+    void add(const T& value)
+    {
+        std::uint64_t h = gset_detail::mix64(static_cast<std::uint64_t>(mHash(value)));
+        std::size_t index = static_cast<std::size_t>(h >> (64 - mPrecision));
+        std::uint64_t rest = h << mPrecision;
+        unsigned char rank = static_cast<unsigned char>(rest == 0 ? 64 - mPrecision + 1 : gset_detail::clz64(rest) + 1);
+
+        if(rank > mRegisters[index])
+            mRegisters[index] = rank;
+    }
+
+    /**
+     * @brief Fonde un altro sketch, ottenendo lo sketch dell'unione.
+     *
+     * @param other Sketch da fondere.
+     *
+     * @throw std::invalid_argument se le precisioni sono diverse.
+     */
+    void merge(const HyperLogLog& other)
+    {
+        if(mPrecision != other.mPrecision)
+            throw std::invalid_argument("precisioni diverse");
+
+        for(std::size_t i = 0; i < mRegisters.size(); i++)
+        {
+            mRegisters[i] = std::max(mRegisters[i], other.mRegisters[i]);
+        }
+    }
+
+    /**
+     * @brief Stima del numero di elementi distinti registrati.
+     *
+     * @return double Cardinalità stimata.
+     */
+    double estimate() const
+    {
+        double m = static_cast<double>(mRegisters.size());
+        double sum = 0;
+        std::size_t zeros = 0;
+        for(std::size_t i = 0; i < mRegisters.size(); i++)
+        {
+            sum += std::ldexp(1.0, -static_cast<int>(mRegisters[i]));
+            if(mRegisters[i] == 0)
+                zeros++;
+        }
+
+        // Correzione del bias: valori tabulati per m < 128 (Flajolet et al.)
+        double alpha = 0.7213 / (1.0 + 1.079 / m);
+        if(m == 16)
+            alpha = 0.673;
+        else if(m == 32)
+            alpha = 0.697;
+        else if(m == 64)
+            alpha = 0.709;
+        double raw = alpha * m * m / sum;
+
+        // Correzione per piccole cardinalità (linear counting)
+        if(raw <= 2.5 * m && zeros > 0)
+            return m * std::log(m / static_cast<double>(zeros));
+
+        return raw;
+    }
+
+    /**
+     * @brief Svuota lo sketch.
+     */
+    void empty()
+    {
+        std::fill(mRegisters.begin(), mRegisters.end(), 0);
+    }
+
+    unsigned getPrecision() const { return mPrecision; }
+
+    /**
+     * @brief Stima della cardinalità dell'unione di due set.
+     */
+    static double union_estimate(const HyperLogLog& a, const HyperLogLog& b)
+    {
+        HyperLogLog u(a);
+        u.merge(b);
+        return u.estimate();
+    }
+
+    /**
+     * @brief Stima della cardinalità dell'intersezione (inclusione-esclusione).
+     *
+     * Poco precisa quando l'intersezione è piccola rispetto all'unione:
+     * in quel caso è preferibile SetSketch.
+     */
+    static double intersection_estimate(const HyperLogLog& a, const HyperLogLog& b)
+    {
+        return std::max(0.0, a.estimate() + b.estimate() - union_estimate(a, b));
+    }
+
+private:
+    std::vector<unsigned char> mRegisters;  //Massimo rango osservato per registro
+    unsigned mPrecision;                    //Bit dell'hash usati per l'indice del registro
+    Hash mHash;                             //Funzione di hash
+};
+
+/**
+ * @brief Sketch MinHash per la stima della similarità di Jaccard.
+ *
+ * Mantiene, per ciascuna di k funzioni di hash, il minimo valore osservato.
+ * La frazione di minimi uguali tra due sketch stima |A ∩ B| / |A ∪ B|
+ * con errore standard circa 1 / sqrt(k).
+ *
+ * @tparam T Tipo degli elementi.
+ * @tparam Hash Funzione di hash, coerente con l'uguaglianza del set.
+ */
+template<typename T, typename Hash = std::hash<T> >
+class MinHash
+{
+public:
+    /**
+     * @brief Costruttore di uno sketch vuoto.
+     *
+     * @param k Numero di funzioni di hash.
+     * @param hash Funzione di hash di base.
+     */
+    explicit MinHash(std::size_t k = 256, const Hash& hash = Hash())
+        : mMins(k, UINT64_MAX), mHash(hash), mEmpty(true)
+    {
+        if(k == 0)
+            throw std::invalid_argument("numero di funzioni di hash non valido");
+    }
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     * @param k Numero di funzioni di hash.
+     * @param hash Funzione di hash di base.
+     */
+    template<typename Iter>
+    MinHash(Iter begin, Iter end, std::size_t k = 256, const Hash& hash = Hash())
+        : mMins(k, UINT64_MAX), mHash(hash), mEmpty(true)
+    {
+        if(k == 0)
+            throw std::invalid_argument("numero di funzioni di hash non valido");
+        for(; begin != end; ++begin)
+        {
+            add(*begin);
+        }
+    }
+
+    /**
+     * @brief Registra un elemento.
+     *
+     * Le k funzioni di hash sono ottenute rimescolando l'hash
+     * dell'elemento con k semi diversi.
+     *
+     * @param value Elemento da registrare.
+     */
+    void add(const T& value)
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(mHash(value));
+        for(std::size_t i = 0; i < mMins.size(); i++)
+        {
+            std::uint64_t hi = gset_detail::mix64(h ^ (0xD6E8FEB86659FD93ULL * (i + 1)));
+            if(hi < mMins[i])
+                mMins[i] = hi;
+        }
+        mEmpty = false;
+    }
+
+    /**
+     * @brief Fonde un altro sketch, ottenendo lo sketch dell'unione.
+     *
+     * @param other Sketch da fondere.
+     *
+     * @throw std::invalid_argument se il numero di funzioni è diverso.
+     */
+    void merge(const MinHash& other)
+    {
+        if(mMins.size() != other.mMins.size())
+            throw std::invalid_argument("numero di funzioni di hash diverso");
+
+        for(std::size_t i = 0; i < mMins.size(); i++)
+        {
+            mMins[i] = std::min(mMins[i], other.mMins[i]);
+        }
+        mEmpty = mEmpty && other.mEmpty;
+    }
+
+    /**
+     * @brief Stima della similarità di Jaccard con un altro sketch.
+     *
+     * @param other Sketch da confrontare.
+     * @return double Similarità stimata in [0, 1] (1 se entrambi vuoti).
+     *
+     * @throw std::invalid_argument se il numero di funzioni è diverso.
+     */
+    double jaccard(const MinHash& other) const
+    {
+        if(mMins.size() != other.mMins.size())
+            throw std::invalid_argument("numero di funzioni di hash diverso");
+        if(mEmpty && other.mEmpty)
+            return 1.0;
+        if(mEmpty || other.mEmpty)
+            return 0.0;
+
+        std::size_t equal = 0;
+        for(std::size_t i = 0; i < mMins.size(); i++)
+        {
+            if(mMins[i] == other.mMins[i])
+                equal++;
+        }
+        return static_cast<double>(equal) / static_cast<double>(mMins.size());
+    }
+
+    /**
+     * @brief Svuota lo sketch.
+     */
+    void empty()
+    {
+        std::fill(mMins.begin(), mMins.end(), UINT64_MAX);
+        mEmpty = true;
+    }
+
+    std::size_t getSize() const { return mMins.size(); }
+
+private:
+    std::vector<std::uint64_t> mMins;   //Minimo per ciascuna funzione di hash
+    Hash mHash;                         //Funzione di hash di base
+    bool mEmpty;                        //Nessun elemento registrato
+};
+
+/**
+ * @brief Sketch combinato per stimare unione, intersezione e Jaccard.
+ *
+ * Associa un HyperLogLog (cardinalità) e un MinHash (similarità):
+ * l'intersezione è stimata come jaccard * |A ∪ B|, più precisa
+ * dell'inclusione-esclusione quando l'intersezione è piccola.
+ * Per mantenere lo sketch aggiornato basta chiamare add
+ * insieme all'add del set.
+ *
+ * @tparam T Tipo degli elementi.
+ * @tparam Hash Funzione di hash, coerente con l'uguaglianza del set.
+ */
+template<typename T, typename Hash = std::hash<T> >
+class SetSketch
+{
+public:
+    /**
+     * @brief Costruttore di uno sketch vuoto.
+     *
+     * @param precision Precisione dell'HyperLogLog.
+     * @param k Numero di funzioni di hash del MinHash.
+     */
+    explicit SetSketch(unsigned precision = 14, std::size_t k = 256, const Hash& hash = Hash())
+        : mCardinality(precision, hash), mSimilarity(k, hash) {}
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     */
+    template<typename Iter>
+    SetSketch(Iter begin, Iter end, unsigned precision = 14, std::size_t k = 256, const Hash& hash = Hash())
+        : mCardinality(precision, hash), mSimilarity(k, hash)
+    {
+        for(; begin != end; ++begin)
+        {
+            add(*begin);
+        }
+    }
+
+    void add(const T& value)
+    {
+        mCardinality.add(value);
+        mSimilarity.add(value);
+    }
+
+    void merge(const SetSketch& other)
+    {
+        mCardinality.merge(other.mCardinality);
+        mSimilarity.merge(other.mSimilarity);
+    }
+
+    double estimate() const { return mCardinality.estimate(); }
+
+    const HyperLogLog<T, Hash>& getCardinality() const { return mCardinality; }
+    const MinHash<T, Hash>& getSimilarity() const { return mSimilarity; }
+
+    /**
+     * @brief Stima di |A ∪ B|.
+     */
+    static double union_estimate(const SetSketch& a, const SetSketch& b)
+    {
+        return HyperLogLog<T, Hash>::union_estimate(a.mCardinality, b.mCardinality);
+    }
+
+    /**
+     * @brief Stima di |A ∩ B|.
+     */
+    static double intersection_estimate(const SetSketch& a, const SetSketch& b)
+    {
+        return a.mSimilarity.jaccard(b.mSimilarity) * union_estimate(a, b);
+    }
+
+    /**
+     * @brief Stima della similarità di Jaccard |A ∩ B| / |A ∪ B|.
+     */
+    static double jaccard(const SetSketch& a, const SetSketch& b)
+    {
+        return a.mSimilarity.jaccard(b.mSimilarity);
+    }
+
+private:
+    HyperLogLog<T, Hash> mCardinality;  //Sketch di cardinalità
+    MinHash<T, Hash> mSimilarity;       //Sketch di similarità
+};
+
+#endif
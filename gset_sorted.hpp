@@ -0,0 +1,443 @@
+/**
+ * @file gset_sorted.hpp
+ *
+ * @brief file header della classe templata SortedSet.
+ *
+ * Definizione e implementazione di un set generico ordinato,
+ * memorizzato in un array contiguo.
+ */
+
+#ifndef GSET_SORTED_HPP
+#define GSET_SORTED_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Classe SortedSet generica.
+ *
+ * La classe implementa un set di oggetti T mantenuti ordinati
+ * secondo il funtore Compare in un array contiguo.
+ * Due elementi a e b sono considerati uguali se
+ * né a < b né b < a secondo Compare.
+ *
+ * La ricerca richiede tempo O(log N) e consente interrogazioni
+ * per intervallo; l'inserimento di molti elementi è efficiente
+ * tramite add(begin, end), che ordina e fonde i nuovi elementi
+ * in un unico passaggio.
+ *
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Compare Funtore di ordinamento stretto.
+ */
+template<typename T, typename Compare = std::less<T> >
+class SortedSet
+{
+public:
+    typedef typename std::vector<T>::size_type size_type;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    /**
+     * @brief Costruttore di default.
+     */
+    SortedSet() {}
+
+    /**
+     * @brief Costruttore con funtore di ordinamento.
+     *
+     * @param comp Funtore di ordinamento.
+     */
+    explicit SortedSet(const Compare& comp) : mComp(comp) {}
+
+    /**
+     * @brief Costruttore da coppia generica di iteratori.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     *
+     * @throw Errore di allocazione
+     */
+    template <typename Iter>
+    SortedSet(Iter begin, Iter end)
+    {
+        add(begin, end);
+    }
+
+    /**
+     * @brief Aggiunge un elemento al set.
+     *
+     * L'elemento viene inserito nella sua posizione ordinata,
+     * spostando gli elementi successivi.
+     *
+     * @param value Valore da aggiungere.
+     * @return true Se l'elemento è stato aggiunto con successo.
+     * @return false Se l'elemento è già presente nel set.
+     */
+    bool add(const T& value)
+    {
+        typename std::vector<T>::iterator pos = std::lower_bound(mData.begin(), mData.end(), value, mComp);
+        if(pos != mData.end() && !mComp(value, *pos))
+            return false; //Elemento già presente
+
+        mData.insert(pos, value);
+        return true;
+    }
+
+    /**
+     * @brief Aggiunge una sequenza di elementi al set.
+     *
+     * I nuovi elementi vengono accodati, ordinati e fusi con
+     * quelli esistenti in un unico passaggio: il costo è
+     * O(M log M + N) invece di uno spostamento per elemento.
+     *
+     * @tparam Iter Tipo dell'iteratore.
+     * @param begin Iteratore di inizio.
+     * @param end Iteratore di fine.
+     * @return size_type Numero di elementi effettivamente aggiunti.
+     */
+    template <typename Iter>
+    size_type add(Iter begin, Iter end)
+    {
+        size_type oldSize = mData.size();
+        mData.insert(mData.end(), begin, end);
+
+        typename std::vector<T>::iterator mid = mData.begin() + oldSize;
+        std::sort(mid, mData.end(), mComp);
+        mid = std::unique(mid, mData.end(), Equivalent(mComp));
+        std::inplace_merge(mData.begin(), mData.begin() + oldSize, mid, mComp);
+        mData.erase(std::unique(mData.begin(), mid, Equivalent(mComp)), mData.end());
+
+        return mData.size() - oldSize;
+    }
+
+    /**
+     * @brief Rimuove un elemento dal set.
+     *
+     * @param value Valore da rimuovere.
+     * @return true Se l'elemento è stato rimosso con successo.
+     * @return false Se l'elemento non è presente nel set.
+     */
+    bool remove(const T& value)
+    {
+        typename std::vector<T>::iterator pos = std::lower_bound(mData.begin(), mData.end(), value, mComp);
+        if(pos == mData.end() || mComp(value, *pos))
+            return false; //Elemento assente
+
+        mData.erase(pos);
+        return true;
+    }
+
+    /**
+     * @brief Verifica se un elemento è presente nel set.
+     *
+     * Ricerca binaria, O(log N).
+     *
+     * @param value Valore da cercare.
+     * @return true se l'elemento è presente.
+     * @return false se l'elemento non è presente.
+     */
+    bool contains(const T& value) const
+    {
+        const_iterator pos = lower_bound(value);
+        return pos != end() && !mComp(value, *pos);
+    }
+
+    /**
+     * @brief Primo elemento non minore di value.
+     *
+     * @param value Valore di riferimento.
+     * @return const_iterator Iteratore al primo elemento >= value, o end().
+     */
+    const_iterator lower_bound(const T& value) const
+    {
+        return std::lower_bound(mData.begin(), mData.end(), value, mComp);
+    }
+
+    /**
+     * @brief Primo elemento maggiore di value.
+     *
+     * @param value Valore di riferimento.
+     * @return const_iterator Iteratore al primo elemento > value, o end().
+     */
+    const_iterator upper_bound(const T& value) const
+    {
+        return std::upper_bound(mData.begin(), mData.end(), value, mComp);
+    }
+
+    /**
+     * @brief Elementi compresi nell'intervallo [from, to).
+     *
+     * @param from Estremo inferiore (incluso).
+     * @param to Estremo superiore (escluso).
+     * @return std::pair<const_iterator, const_iterator> Coppia di iteratori inizio/fine.
+     */
+    std::pair<const_iterator, const_iterator> range(const T& from, const T& to) const
+    {
+        const_iterator first = lower_bound(from);
+        const_iterator last = mComp(from, to) ? std::lower_bound(first, end(), to, mComp) : first;
+        return std::make_pair(first, last);
+    }
+
+    /**
+     * @brief Svuota il set.
+     *
+     * @post getSize() = 0, getCapacity() = 0
+     */
+    void empty()
+    {
+        std::vector<T>().swap(mData);
+    }
+
+    /**
+     * @brief Operatore di accesso agli elementi del set (in ordine).
+     *
+     * @param index Indice dell'elemento.
+     * @return T elemento.
+     *
+     * @throw std::out_of_range se l'indice è fuori dai limit.
+     */
+    T operator[](size_type index) const
+    {
+        if(index >= mData.size())
+            throw std::out_of_range("index out of bounds"); //index out of bounds
+        return mData[index];
+    }
+
+    /**
+     * @brief Operatore di confronto di uguaglianza tra set.
+     *
+     * @param other Altro set da confrontare.
+     * @return true Se i set sono uguali.
+     * @return false Se i set non sono uguali.
+     */
+    bool operator==(const SortedSet& other) const
+    {
+        return mData.size() == other.mData.size() &&
+               std::equal(mData.begin(), mData.end(), other.mData.begin(), Equivalent(mComp));
+    }
+
+    /**
+     * @brief Operatore di stream per la stampa del set.
+     *
+     * @param out Stream di output.
+     * @param set Set da stampare.
+     * @return std::ostream& Stream di output.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const SortedSet& set)
+    {
+        out << set.getSize();
+        for(const_iterator i = set.begin(); i != set.end(); ++i)
+        {
+            out << " (" << *i << ")";
+        }
+
+        return out;
+    }
+
+    size_type getSize() const { return mData.size(); }
+    size_type getCapacity() const { return mData.capacity(); }
+
+	/**
+     * @brief Ritorna l'iteratore all'inizio della sequenza dati.
+     *
+     * @return const_iterator Iteratore all'inizio della sequenza dati.
+     */
+    const_iterator begin() const
+    {
+        return mData.begin();
+    }
+
+	/**
+     * @brief Ritorna l'iteratore alla fine della sequenza dati.
+     *
+     * @return const_iterator Iteratore alla fine della sequenza dati.
+     */
+    const_iterator end() const
+    {
+        return mData.end();
+    }
+
+    /**
+     * @brief Operatore di unione tra set ordinati.
+     *
+     * Funzione GLOBALE che fonde i due array ordinati in tempo lineare.
+     *
+     * @param set1 Primo set da unire.
+     * @param set2 Altro set da unire.
+     * @return SortedSet Unione dei due set.
+     */
+    friend SortedSet operator+(const SortedSet& set1, const SortedSet& set2)
+    {
+        SortedSet res(set1.mComp);
+        res.mData.reserve(set1.getSize() + set2.getSize());
+        std::set_union(set1.begin(), set1.end(), set2.begin(), set2.end(),
+                       std::back_inserter(res.mData), set1.mComp);
+        return res;
+    }
+
+    /**
+     * @brief Operatore di intersezione tra set ordinati.
+     *
+     * Funzione GLOBALE che fonde i due array ordinati in tempo lineare.
+     *
+     * @param set1 Primo set da intersecare.
+     * @param set2 Altro set da intersecare.
+     * @return SortedSet Intersezione dei due set.
+     */
+    friend SortedSet operator-(const SortedSet& set1, const SortedSet& set2)
+    {
+        SortedSet res(set1.mComp);
+        res.mData.reserve(std::min(set1.getSize(), set2.getSize()));
+        std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(),
+                              std::back_inserter(res.mData), set1.mComp);
+        return res;
+    }
+
+    /**
+     * @brief Cardinalità dell'intersezione tra set ordinati.
+     *
+     * Funzione GLOBALE che conta gli elementi comuni senza costruire
+     * l'intersezione. Gli elementi del set più piccolo vengono cercati
+     * nel più grande con una fusione lineare o, se le dimensioni sono
+     * molto diverse, con ricerche binarie.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi comuni.
+     */
+    friend size_type intersection_size(const SortedSet& set1, const SortedSet& set2)
+    {
+        return countCommon(set1, set2, false);
+    }
+
+    /**
+     * @brief Cardinalità dell'unione tra set ordinati.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return size_type Numero di elementi dell'unione.
+     */
+    friend size_type union_size(const SortedSet& set1, const SortedSet& set2)
+    {
+        return set1.getSize() + set2.getSize() - countCommon(set1, set2, false);
+    }
+
+    /**
+     * @brief Verifica se set1 è un sottoinsieme di set2.
+     *
+     * Termina al primo elemento di set1 assente in set2.
+     *
+     * @param set1 Set da verificare.
+     * @param set2 Set che dovrebbe contenerlo.
+     * @return true se ogni elemento di set1 è presente in set2.
+     * @return false altrimenti.
+     */
+    friend bool is_subset_of(const SortedSet& set1, const SortedSet& set2)
+    {
+        if(set1.getSize() > set2.getSize())
+            return false;
+
+        bool bisect = useBisection(set1, set2);
+        const_iterator j = set2.begin();
+        for(const_iterator i = set1.begin(); i != set1.end(); ++i)
+        {
+            j = set2.seek(j, *i, bisect);
+            if(j == set2.end() || set2.mComp(*i, *j))
+                return false;
+            ++j;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Verifica se due set ordinati non hanno elementi in comune.
+     *
+     * Termina al primo elemento comune.
+     *
+     * @param set1 Primo set.
+     * @param set2 Altro set.
+     * @return true se i set sono disgiunti.
+     * @return false altrimenti.
+     */
+    friend bool is_disjoint(const SortedSet& set1, const SortedSet& set2)
+    {
+        return countCommon(set1, set2, true) == 0;
+    }
+
+private:
+    // Bisezione se small è molto più piccolo di large, altrimenti fusione lineare
+    static bool useBisection(const SortedSet& small, const SortedSet& large)
+    {
+        return small.getSize() * 8 < large.getSize();
+    }
+
+    /**
+     * @brief Primo elemento >= value a partire da from.
+     *
+     * @param from Posizione di partenza (gli elementi precedenti sono < value).
+     * @param value Valore cercato.
+     * @param bisect Ricerca binaria invece di scansione lineare.
+     */
+    const_iterator seek(const_iterator from, const T& value, bool bisect) const
+    {
+        if(bisect)
+            return std::lower_bound(from, end(), value, mComp);
+
+        while(from != end() && mComp(*from, value))
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    // Conta gli elementi comuni scorrendo il set più piccolo (al più 1 se stopAtFirst)
+    static size_type countCommon(const SortedSet& set1, const SortedSet& set2, bool stopAtFirst)
+    {
+        const SortedSet& small = set1.getSize() <= set2.getSize() ? set1 : set2;
+        const SortedSet& large = set1.getSize() <= set2.getSize() ? set2 : set1;
+
+        bool bisect = useBisection(small, large);
+        size_type count = 0;
+        const_iterator j = large.begin();
+        for(const_iterator i = small.begin(); i != small.end() && j != large.end(); ++i)
+        {
+            j = large.seek(j, *i, bisect);
+            if(j != large.end() && !large.mComp(*i, *j))
+            {
+                count++;
+                if(stopAtFirst)
+                    break;
+                ++j;
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Funtore di equivalenza derivato da Compare.
+     */
+    struct Equivalent
+    {
+        explicit Equivalent(const Compare& c) : comp(c) {}
+
+        bool operator()(const T& a, const T& b) const
+        {
+            return !comp(a, b) && !comp(b, a);
+        }
+
+        Compare comp;
+    };
+
+private:
+    std::vector<T> mData;   //Elementi ordinati secondo Compare
+    Compare mComp;          //Funtore di ordinamento
+};
+
+#endif
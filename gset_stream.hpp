@@ -0,0 +1,398 @@
+/**
+ * @file gset_stream.hpp
+ *
+ * @brief file header della costruzione di un Set da uno stream.
+ *
+ * Definizione e implementazione di stream_build, che legge uno stream
+ * di record separati da '\n' a blocchi, ne esegue il parsing tramite
+ * una funzione fornita dall'utente e deduplica gli elementi in parallelo.
+ */
+
+#ifndef GSET_STREAM_HPP
+#define GSET_STREAM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gset.hpp"
+
+/**
+ * @brief Parser di default: ogni riga diventa una stringa.
+ */
+struct LineParser
+{
+    bool operator()(const char* begin, const char* end, std::string& out) const
+    {
+        out.assign(begin, end);
+        return true;
+    }
+};
+
+namespace gset_detail
+{
+    /**
+     * @brief Coda limitata di blocchi letti dallo stream.
+     *
+     * push si blocca quando la coda è piena, limitando la memoria
+     * occupata dai blocchi in attesa di parsing.
+     */
+    class ChunkQueue
+    {
+    public:
+        explicit ChunkQueue(std::size_t capacity) : mCapacity(capacity), mClosed(false) {}
+
+        /**
+         * @brief Accoda un blocco, attendendo se la coda è piena.
+         *
+         * @return false se la coda è stata chiusa.
+         */
+        bool push(std::string& chunk)
+        {
+            std::unique_lock<std::mutex> guard(mLock);
+            mNotFull.wait(guard, [this] { return mClosed || mChunks.size() < mCapacity; });
+            if(mClosed)
+                return false;
+
+            mChunks.push_back(std::string());
+            mChunks.back().swap(chunk);
+            mNotEmpty.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Estrae un blocco, attendendo se la coda è vuota.
+         *
+         * @return false se la coda è chiusa e vuota.
+         */
+        bool pop(std::string& chunk)
+        {
+            std::unique_lock<std::mutex> guard(mLock);
+            mNotEmpty.wait(guard, [this] { return mClosed || !mChunks.empty(); });
+            if(mChunks.empty())
+                return false;
+
+            chunk.swap(mChunks.front());
+            mChunks.pop_front();
+            mNotFull.notify_one();
+            return true;
+        }
+
+        // Nessun altro blocco verrà accodato
+        void close()
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            mClosed = true;
+            mNotEmpty.notify_all();
+            mNotFull.notify_all();
+        }
+
+    private:
+        std::mutex mLock;
+        std::condition_variable mNotEmpty;
+        std::condition_variable mNotFull;
+        std::deque<std::string> mChunks;    //Blocchi in attesa
+        std::size_t mCapacity;              //Numero massimo di blocchi in attesa
+        bool mClosed;                       //Lettura terminata o interrotta
+    };
+
+    /**
+     * @brief Elemento letto dallo stream con il suo hash.
+     */
+    template<typename T>
+    struct HashedValue
+    {
+        T value;
+        std::size_t hash;
+    };
+
+    template<typename T>
+    struct HashedValueHash
+    {
+        std::size_t operator()(const HashedValue<T>& v) const { return v.hash; }
+    };
+
+    template<typename T, typename Equal>
+    struct HashedValueEqual
+    {
+        bool operator()(const HashedValue<T>& a, const HashedValue<T>& b) const
+        {
+            return a.hash == b.hash && eq(a.value, b.value);
+        }
+
+        Equal eq;
+    };
+
+    /**
+     * @brief Partizione di hash degli elementi distinti.
+     */
+    template<typename T, typename Equal>
+    struct StreamPartition
+    {
+        std::mutex lock;
+        std::unordered_set<HashedValue<T>, HashedValueHash<T>, HashedValueEqual<T, Equal> > seen;
+        std::vector<const T*> order;    //Elementi distinti in ordine di inserimento
+    };
+
+    /**
+     * @brief Esegue il parsing di un blocco e ne deduplica gli elementi.
+     *
+     * Gli elementi vengono prima raggruppati per partizione,
+     * così che il lock di ogni partizione sia acquisito una sola volta per blocco.
+     */
+    template<typename T, typename Equal, typename Parser, typename Hash>
+    void ingestChunk(const std::string& chunk, Parser& parse, Hash& hash,
+                     std::vector<StreamPartition<T, Equal> >& parts,
+                     std::vector<std::vector<HashedValue<T> > >& batches)
+    {
+        const char* p = chunk.data();
+        const char* end = p + chunk.size();
+        while(p < end)
+        {
+            const char* eol = std::find(p, end, '\n');
+            HashedValue<T> item;
+            if(parse(p, eol, item.value))
+            {
+                item.hash = hash(item.value);
+                batches[item.hash % parts.size()].push_back(std::move(item));
+            }
+            p = eol + 1;
+        }
+
+        for(std::size_t k = 0; k < parts.size(); k++)
+        {
+            if(batches[k].empty())
+                continue;
+
+            StreamPartition<T, Equal>& part = parts[k];
+            std::lock_guard<std::mutex> guard(part.lock);
+            for(std::size_t i = 0; i < batches[k].size(); i++)
+            {
+                std::pair<typename std::unordered_set<HashedValue<T>, HashedValueHash<T>,
+                          HashedValueEqual<T, Equal> >::iterator, bool> res = part.seen.insert(std::move(batches[k][i]));
+                if(res.second)
+                    part.order.push_back(&res.first->value);
+            }
+            batches[k].clear();
+        }
+    }
+}
+
+/**
+ * @brief Costruisce un set dai record di uno stream.
+ *
+ * Funzione GLOBALE che legge lo stream a blocchi di chunkBytes byte,
+ * spezzati sull'ultimo '\n', e chiama parse(begin, end, out) su ogni
+ * record (senza il '\n' finale). I record per cui parse ritorna false
+ * vengono scartati.
+ *
+ * Con threads > 1 il thread chiamante legge lo stream mentre threads
+ * thread eseguono il parsing e la deduplicazione, suddivisa per partizioni
+ * di hash. La coda tra lettura e parsing contiene al più queueDepth blocchi:
+ * la memoria occupata, oltre agli elementi distinti, è quindi limitata
+ * a circa (queueDepth + threads) * chunkBytes byte. In questo caso l'ordine
+ * degli elementi del risultato non è specificato; con threads = 1
+ * gli elementi compaiono in ordine di prima occorrenza.
+ *
+ * @tparam T Tipo degli elementi nel set.
+ * @tparam Equal Funtore per il confronto di uguaglianza.
+ * @tparam Parser Funzione chiamata come parse(const char*, const char*, T&) -> bool.
+ * @tparam Hash Funzione di hash coerente con il funtore di uguaglianza.
+ * @param in Stream di input.
+ * @param parse Funzione di parsing dei record.
+ * @param hash Funzione di hash.
+ * @param threads Numero di thread di parsing (0 = numero di core disponibili).
+ * @param chunkBytes Dimensione dei blocchi letti dallo stream.
+ * @param queueDepth Numero massimo di blocchi in attesa di parsing.
+ * @return Set Elementi distinti dello stream.
+ *
+ * @throw std::runtime_error in caso di errore di lettura.
+ * @throw La prima eccezione sollevata da parse o hash.
+ * @throw std::system_error se un thread di parsing non può essere creato.
+ */
+template<typename T, typename Equal, typename Parser, typename Hash>
+Set<T, Equal> stream_build(std::istream& in, Parser parse, Hash hash, unsigned threads = 0,
+                           std::size_t chunkBytes = 1 << 20, std::size_t queueDepth = 4)
+{
+    typedef gset_detail::StreamPartition<T, Equal> partition;
+    typedef std::vector<gset_detail::HashedValue<T> > batch;
+
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    if(chunkBytes == 0)
+        chunkBytes = 1;
+    if(queueDepth == 0)
+        queueDepth = 1;
+
+    // Con un solo thread una partizione preserva l'ordine di prima occorrenza
+    std::vector<partition> parts(threads <= 1 ? 1 : threads * 4);
+
+    gset_detail::ChunkQueue queue(queueDepth);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    auto fail = [&]()
+    {
+        std::lock_guard<std::mutex> guard(errorLock);
+        if(!error)
+            error = std::current_exception();
+        failed.store(true);
+        queue.close();
+    };
+
+    auto worker = [&]()
+    {
+        try
+        {
+            Parser p(parse);
+            Hash h(hash);
+            std::vector<batch> batches(parts.size());
+            std::string chunk;
+            while(queue.pop(chunk))
+            {
+                if(failed.load(std::memory_order_relaxed))
+                    continue; //Svuota la coda senza elaborare
+                gset_detail::ingestChunk<T, Equal>(chunk, p, h, parts, batches);
+            }
+        }
+        catch(...)
+        {
+            fail();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    if(threads > 1)
+    {
+        pool.reserve(threads);
+        try
+        {
+            for(unsigned t = 0; t < threads; t++)
+            {
+                pool.push_back(std::thread(worker));
+            }
+        }
+        catch(...)
+        {
+            // Creazione di un thread fallita: sblocca e attende i thread avviati
+            queue.close();
+            for(std::size_t t = 0; t < pool.size(); t++)
+            {
+                pool[t].join();
+            }
+            throw;
+        }
+    }
+
+    try
+    {
+        std::vector<batch> batches(threads > 1 ? 0 : parts.size());
+        std::string carry;
+        bool more = true;
+        while(more && !failed.load(std::memory_order_relaxed))
+        {
+            std::string chunk;
+            chunk.swap(carry);
+            std::size_t old = chunk.size();
+            chunk.resize(old + chunkBytes);
+            in.read(&chunk[old], static_cast<std::streamsize>(chunkBytes));
+            std::size_t got = static_cast<std::size_t>(in.gcount());
+            chunk.resize(old + got);
+
+            if(in.bad())
+                throw std::runtime_error("Errore di lettura dello stream");
+
+            more = got == chunkBytes;
+            if(more)
+            {
+                // L'ultimo record incompleto passa al blocco successivo
+                std::size_t nl = chunk.rfind('\n');
+                if(nl == std::string::npos)
+                {
+                    carry.swap(chunk);
+                    continue;
+                }
+                carry.assign(chunk, nl + 1, std::string::npos);
+                chunk.resize(nl + 1);
+            }
+
+            if(chunk.empty())
+                continue;
+
+            if(threads > 1)
+            {
+                if(!queue.push(chunk))
+                    break;
+            }
+            else
+            {
+                gset_detail::ingestChunk<T, Equal>(chunk, parse, hash, parts, batches);
+            }
+        }
+    }
+    catch(...)
+    {
+        fail();
+    }
+
+    queue.close();
+    for(std::size_t t = 0; t < pool.size(); t++)
+    {
+        pool[t].join();
+    }
+
+    if(error)
+        std::rethrow_exception(error);
+
+    std::size_t total = 0;
+    for(std::size_t k = 0; k < parts.size(); k++)
+    {
+        total += parts[k].order.size();
+    }
+
+    std::vector<const T*> unique;
+    unique.reserve(total);
+    for(std::size_t k = 0; k < parts.size(); k++)
+    {
+        unique.insert(unique.end(), parts[k].order.begin(), parts[k].order.end());
+    }
+
+    const T* const* data = unique.empty() ? nullptr : &unique[0];
+    return Set<T, Equal>(assume_unique, gset_detail::IndirectIterator<T>(data),
+                         gset_detail::IndirectIterator<T>(data + unique.size()));
+}
+
+/**
+ * @brief Costruisce un set dai record di un file.
+ *
+ * Come stream_build(std::istream&, ...), con il file aperto in modalità binaria.
+ *
+ * @param path Percorso del file.
+ *
+ * @throw std::runtime_error se il file non può essere aperto o letto.
+ */
+template<typename T, typename Equal, typename Parser, typename Hash>
+Set<T, Equal> stream_build(const std::string& path, Parser parse, Hash hash, unsigned threads = 0,
+                           std::size_t chunkBytes = 1 << 20, std::size_t queueDepth = 4)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Impossibile aprire il file per la lettura");
+
+    return stream_build<T, Equal>(file, parse, hash, threads, chunkBytes, queueDepth);
+}
+
+#endif
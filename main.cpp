@@ -2,7 +2,22 @@
 #include <vector>
 #include <cassert>
 #include <sstream>
+#include <cstdio>
+#include <functional>
+#include <cmath>
+#include <atomic>
 #include "gset.hpp"
+#include "gset_bitmap.hpp"
+#include "gset_compressed.hpp"
+#include "gset_sorted.hpp"
+#include "gset_sketch.hpp"
+#include "gset_parallel.hpp"
+#include "gset_stream.hpp"
+#ifndef _WIN32
+#include "gset_mmap.hpp"
+#include "gset_journal.hpp"
+#include <sys/stat.h>
+#endif
 
 /**
  * @brief Funtore di uguaglianza tra tipi interi.
@@ -335,8 +350,8 @@ void testMetodiBookSet()
  * @tparam Equal Funtore per il confronto di uguaglianza. 
  * @param testSet Set oggetto del test.
  */
-template<typename T, typename Equal>
-void testMetodiDiIterazione(const Set<T, Equal>& testSet)
+template<typename T, typename Equal, typename Size>
+void testMetodiDiIterazione(const Set<T, Equal, Size>& testSet)
 {
     std::cout << "******** Test metodi di iterazione del set generico ********" << std::endl;
 
@@ -498,6 +513,1531 @@ void testSave()
     
 }
 
+/**
+ * @brief Test del set bitmap.
+ * 
+ * Test dei metodi e degli operatori globali su un set di interi
+ * con universo limitato.
+ * 
+ */
+void testBitmapSet()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test set bitmap ********" << std::endl;
+
+    typedef BitmapSet<int, -10, 200> ShardSet;
+
+    ShardSet a;
+    std::cout << "- Test add degli elementi: { 5, 8, 8, -10, 200, 64, 63 }" << std::endl;
+    a.add(5);
+    a.add(8);
+    assert(a.add(8) == false);
+    a.add(-10);
+    a.add(200);
+    a.add(64);
+    a.add(63);
+
+    std::cout << a << std::endl;
+    ss << a;
+    assert(a.getSize() == 6);
+    assert(a.getCapacity() == 211);
+    assert(ss.str() == "6 (-10) (5) (8) (63) (64) (200)");
+    ss.str("");
+
+    assert(a[0] == -10);
+    assert(a[3] == 63);
+    assert(a[5] == 200);
+    assert(a.contains(64));
+    assert(!a.contains(65));
+    assert(!a.contains(1000));
+
+    bool thrown = false;
+    try
+    {
+        a.add(201);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "- Test remove degli elementi: {8, 200, 7}" << std::endl;
+    assert(a.remove(8));
+    assert(a.remove(200));
+    assert(a.remove(7) == false);
+    ss << a;
+    assert(ss.str() == "4 (-10) (5) (63) (64)");
+    ss.str("");
+
+    int testArray[] = {63, 64, 65, 100, 100, -10};
+    ShardSet b(testArray, testArray + 6);
+
+    std::cout << "- Test unione e intersezione tra set" << std::endl;
+    ShardSet u = a + b;
+    ShardSet in = a - b;
+    std::cout << u << std::endl;
+    std::cout << in << std::endl;
+    ss << u;
+    assert(ss.str() == "6 (-10) (5) (63) (64) (65) (100)");
+    ss.str("");
+    ss << in;
+    assert(ss.str() == "3 (-10) (63) (64)");
+    ss.str("");
+
+    ShardSet c;
+    c = in;
+    assert(c == in);
+    c.empty();
+    assert(c.getSize() == 0);
+    assert(c.begin() == c.end());
+
+    std::cout << "- Test intero intervallo di un tipo con segno" << std::endl;
+    BitmapSet<signed char, -128, 127> full;
+    assert(full.getCapacity() == 256);
+    full.add(-128);
+    full.add(127);
+    ss << full;
+    assert(ss.str() == "2 (-128) (127)");
+    ss.str("");
+}
+
+/**
+ * @brief Test del set compresso.
+ * 
+ * Test dei contenitori array, bitmap e run, degli operatori
+ * globali e del salvataggio su file.
+ * 
+ */
+void testCompressedSet()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test set compresso ********" << std::endl;
+
+    CompressedSet a;
+    std::cout << "- Test add degli elementi: { 5, 8, 8, 70000, 4294967295 }" << std::endl;
+    a.add(5);
+    a.add(8);
+    assert(a.add(8) == false);
+    a.add(70000);
+    a.add(4294967295u);
+    std::cout << a << std::endl;
+    ss << a;
+    assert(ss.str() == "4 (5) (8) (70000) (4294967295)");
+    ss.str("");
+    assert(a.getChunkCount() == 3);
+    assert(a[2] == 70000);
+    assert(a.contains(4294967295u));
+    assert(!a.contains(6));
+
+    std::cout << "- Test contenitori bitmap e run (10000 valori consecutivi)" << std::endl;
+    CompressedSet b;
+    for(std::uint32_t v = 100000; v < 110000; v++)
+    {
+        b.add(v);
+    }
+    b.add(8);
+    assert(b.getSize() == 10001);
+    std::size_t bitmapBytes = b.memory_usage();
+    assert(b.runOptimize());
+    assert(b.memory_usage() < bitmapBytes);
+    assert(b.contains(105000));
+    assert(!b.contains(110000));
+    assert(b[1] == 100000);
+    assert(b[10000] == 109999);
+
+    std::uint64_t count = 0;
+    std::uint32_t prev = 0;
+    for(CompressedSet::const_iterator i = b.begin(); i != b.end(); ++i)
+    {
+        assert(count == 0 || *i > prev);
+        prev = *i;
+        count++;
+    }
+    assert(count == b.getSize());
+
+    std::cout << "- Test unione e intersezione tra set" << std::endl;
+    CompressedSet u = a + b;
+    CompressedSet in = a - b;
+    assert(u.getSize() == 10004);
+    assert(u.contains(70000) && u.contains(105000));
+    ss << in;
+    assert(ss.str() == "1 (8)");
+    ss.str("");
+
+    assert(b.remove(105000));
+    assert(!b.remove(105000));
+    assert(b.getSize() == 10000);
+
+    std::cout << "- Test save e load" << std::endl;
+    save(u, "compressedSet.bin");
+    CompressedSet loaded;
+    load(loaded, "compressedSet.bin");
+    assert(loaded == u);
+    u.runOptimize();
+    assert(loaded == u);
+    std::remove("compressedSet.bin");
+
+    std::cout << "- Test deserialize con dati non validi" << std::endl;
+    // Intestazione e un contenitore: chiave, tipo, cardinalità e contenuto
+    auto corrupted = [](std::uint32_t chunks, unsigned char type, std::uint32_t card,
+                        const std::vector<std::uint16_t>& values, std::size_t words)
+    {
+        std::string data("GSRS");
+        for(int i = 0; i < 4; i++) data += static_cast<char>(chunks >> (8 * i));
+        data += '\0'; data += '\0';
+        data += static_cast<char>(type);
+        for(int i = 0; i < 4; i++) data += static_cast<char>(card >> (8 * i));
+        if(type == 2)
+            for(int i = 0; i < 4; i++) data += static_cast<char>((values.size() / 2) >> (8 * i));
+        for(std::size_t v = 0; v < values.size(); v++)
+        {
+            data += static_cast<char>(values[v]);
+            data += static_cast<char>(values[v] >> 8);
+        }
+        data += std::string(words * 8, '\0');
+        return data;
+    };
+
+    std::vector<std::string> invalid;
+    invalid.push_back(corrupted(0xFFFFFFFFu, 0, 1, std::vector<std::uint16_t>(1, 5), 0));
+    invalid.push_back(corrupted(1, 1, 5, std::vector<std::uint16_t>(), 1024));     //Bitmap con card != popcount
+    std::vector<std::uint16_t> unsorted;
+    unsorted.push_back(9); unsorted.push_back(3);
+    invalid.push_back(corrupted(1, 0, 2, unsorted, 0));                            //Array non ordinato
+    invalid.push_back(corrupted(1, 0, 5000, std::vector<std::uint16_t>(5000, 1), 0)); //Array troppo grande
+    std::vector<std::uint16_t> overlapping;
+    overlapping.push_back(10); overlapping.push_back(9);
+    overlapping.push_back(15); overlapping.push_back(0);
+    invalid.push_back(corrupted(1, 2, 11, overlapping, 0));                        //Run sovrapposti
+    std::vector<std::uint16_t> run;
+    run.push_back(10); run.push_back(9);
+    invalid.push_back(corrupted(1, 2, 7, run, 0));                                 //Card != somma dei run
+    std::vector<std::uint16_t> overflow;
+    overflow.push_back(65530); overflow.push_back(10);
+    invalid.push_back(corrupted(1, 2, 11, overflow, 0));                           //Run oltre il blocco
+
+    for(std::size_t i = 0; i < invalid.size(); i++)
+    {
+        std::istringstream in(invalid[i]);
+        CompressedSet bad;
+        bool thrown = false;
+        try
+        {
+            bad.deserialize(in);
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    std::istringstream valid(corrupted(1, 2, 10, run, 0));
+    CompressedSet ok;
+    ok.deserialize(valid);
+    assert(ok.getSize() == 10 && ok.contains(10) && ok.contains(19) && !ok.contains(20));
+}
+
+/**
+ * @brief Funtore di ordinamento tra libri (per ISBN).
+ */
+struct compareBook
+{
+    bool operator()(const Book& a, const Book& b) const
+    {
+        return a.getISBN() < b.getISBN();
+    }
+};
+
+/**
+ * @brief Test del set ordinato.
+ * 
+ * Test di ricerca binaria, interrogazioni per intervallo,
+ * inserimento a blocchi e operatori globali.
+ * 
+ */
+void testSortedSet()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test set ordinato ********" << std::endl;
+
+    SortedSet<int> a;
+    std::cout << "- Test add degli elementi: { 5, 8, 8, 1, 4 }" << std::endl;
+    a.add(5);
+    a.add(8);
+    assert(a.add(8) == false);
+    a.add(1);
+    a.add(4);
+    std::cout << a << std::endl;
+    ss << a;
+    assert(ss.str() == "4 (1) (4) (5) (8)");
+    ss.str("");
+
+    std::cout << "- Test add a blocchi: { 9, 3, 4, 9, 2, 8 }" << std::endl;
+    int block[] = {9, 3, 4, 9, 2, 8};
+    assert(a.add(block, block + 6) == 3);
+    ss << a;
+    assert(ss.str() == "7 (1) (2) (3) (4) (5) (8) (9)");
+    ss.str("");
+
+    assert(a.contains(3));
+    assert(!a.contains(6));
+    assert(*a.lower_bound(6) == 8);
+    assert(*a.upper_bound(4) == 5);
+    assert(a.upper_bound(9) == a.end());
+
+    std::cout << "- Test intervallo [3, 8)" << std::endl;
+    std::pair<SortedSet<int>::const_iterator, SortedSet<int>::const_iterator> r = a.range(3, 8);
+    for(SortedSet<int>::const_iterator i = r.first; i != r.second; ++i)
+    {
+        ss << *i << " ";
+    }
+    assert(ss.str() == "3 4 5 ");
+    ss.str("");
+
+    assert(a.remove(5));
+    assert(!a.remove(5));
+
+    int other[] = {2, 4, 6, 10};
+    SortedSet<int> b(other, other + 4);
+    ss << (a + b);
+    assert(ss.str() == "8 (1) (2) (3) (4) (6) (8) (9) (10)");
+    ss.str("");
+    ss << (a - b);
+    assert(ss.str() == "2 (2) (4)");
+    ss.str("");
+
+    std::cout << "- Test set ordinato di libri" << std::endl;
+    SortedSet<Book, compareBook> books;
+    books.add(Book("9780151660346", "1984"));
+    books.add(Book("8869183157", "Harry Potter and the Sorcerer's Stone"));
+    books.add(Book("978349803808", "To Kill a Mockingbird"));
+    assert(books.contains(Book("8869183157", "")));
+    std::cout << books << std::endl;
+    ss << books;
+    assert(ss.str() == "3 (8869183157: Harry Potter and the Sorcerer's Stone) (9780151660346: 1984) (978349803808: To Kill a Mockingbird)");
+    ss.str("");
+}
+
+/**
+ * @brief Test della rimozione differita.
+ * 
+ * Test di remove con tombstone, iterazione che salta gli slot
+ * rimossi, compattazione automatica e con compact().
+ * 
+ */
+void testRimozioneDifferita()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test rimozione differita ********" << std::endl;
+
+    IntSet intSet;
+    intSet.setCompactRatio(0.5);
+    for(int i = 0; i < 10; i++)
+    {
+        intSet.add(i);
+    }
+
+    std::cout << "- Test remove degli elementi: {1, 3, 5, 42}" << std::endl;
+    assert(intSet.remove(1));
+    assert(intSet.remove(3));
+    assert(intSet.remove(5));
+    assert(intSet.remove(42) == false);
+    assert(intSet.remove(3) == false);
+    std::cout << intSet << std::endl;
+    ss << intSet;
+    assert(ss.str() == "7 (0) (2) (4) (6) (7) (8) (9)");
+    ss.str("");
+    assert(intSet.getSize() == 7);
+    assert(!intSet.contains(3));
+    assert(intSet[1] == 2);
+    assert(intSet[6] == 9);
+
+    std::cout << "- Test accesso per indice con slot rimossi" << std::endl;
+    StringSet words;
+    words.setCompactRatio(1);
+    const char* letters[] = {"a", "b", "c", "d", "e"};
+    for(int i = 0; i < 5; i++)
+    {
+        words.add(letters[i]);
+    }
+    words.remove("b");
+    words.remove("d");
+    const StringSet& constWords = words;
+    StringSet::size_type position = 0;
+    for(StringSet::const_iterator it = constWords.begin(); it != constWords.end(); ++it, ++position)
+    {
+        assert(constWords[position] == *it); //L'accesso in sola lettura non sposta gli elementi
+    }
+    assert(position == 3);
+    assert(words[2] == "e");
+    assert(words[0] == "a");
+    ss << words;
+    assert(ss.str() == "3 (a) (c) (e)");
+    ss.str("");
+    words.add("f");
+    words.remove("a");
+    assert(words[2] == "f");
+
+    IntSet copy(intSet);
+    assert(copy == intSet);
+    auto filtered = filter_out(intSet, predicateInt());
+    ss << filtered;
+    assert(ss.str() == "4 (6) (7) (8) (9)");
+    ss.str("");
+
+    std::cout << "- Test compattazione automatica (soglia 0.5)" << std::endl;
+    intSet.remove(0);
+    intSet.remove(2);
+    ss << intSet;
+    assert(ss.str() == "5 (4) (6) (7) (8) (9)");
+    ss.str("");
+    assert(intSet[0] == 4);
+
+    std::cout << "- Test compact() e riuso degli slot" << std::endl;
+    intSet.remove(7);
+    intSet.compact();
+    intSet.add(100);
+    ss << intSet;
+    assert(ss.str() == "5 (4) (6) (8) (9) (100)");
+    ss.str("");
+
+    intSet.remove(4);
+    intSet.setCompactRatio(0);
+    intSet.remove(6);
+    ss << intSet;
+    assert(ss.str() == "3 (8) (9) (100)");
+    ss.str("");
+}
+
+/**
+ * @brief Test di viste filtrate e retain_if.
+ * 
+ * Test della vista filtrata non proprietaria, di retain_if
+ * e della costruzione da elementi già distinti.
+ * 
+ */
+void testViste()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test viste filtrate e retain_if ********" << std::endl;
+
+    int testArray[] = {4, 7, 765, 56, 65, 33, 1, 8};
+    IntSet intSet(testArray, testArray + 8);
+
+    std::cout << "- Test vista filtrata (true se > 5)" << std::endl;
+    auto view = filter_view(intSet, predicateInt());
+    assert(view.count() == 6);
+    for(auto i = view.begin(); i != view.end(); ++i)
+    {
+        ss << *i << " ";
+    }
+    assert(ss.str() == "7 765 56 65 33 8 ");
+    ss.str("");
+
+    std::cout << "- Test costruzione da elementi distinti" << std::endl;
+    IntSet unique(assume_unique, testArray, testArray + 8);
+    assert(unique.getCapacity() == 8);
+    assert(unique == intSet);
+
+    std::cout << "- Test retain_if (true se > 5)" << std::endl;
+    intSet.setCompactRatio(1);
+    intSet.remove(765);
+    assert(intSet.retain_if(predicateInt()) == 2);
+    std::cout << intSet << std::endl;
+    ss << intSet;
+    assert(ss.str() == "5 (7) (56) (65) (33) (8)");
+    ss.str("");
+    intSet.add(2);
+    assert(intSet[5] == 2);
+
+    std::cout << "- Test retain_if con predicato che solleva un'eccezione" << std::endl;
+    IntSet partial;
+    partial.setCompactRatio(1);
+    for(int i = 0; i <= 4; i++)
+    {
+        partial.add(i);
+    }
+    partial.remove(0);
+    bool thrown = false;
+    try
+    {
+        partial.retain_if([](int v) -> bool
+        {
+            if(v == 3)
+                throw std::runtime_error("Predicato fallito");
+            return v != 1;
+        });
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    ss << partial;
+    assert(ss.str() == "3 (2) (3) (4)");
+    ss.str("");
+    assert(partial[2] == 4 && !partial.contains(1));
+    partial.add(5);
+    assert(partial.getSize() == 4 && partial[3] == 5);
+
+    BookSet bookSet;
+    bookSet.add(Book("9780151660346", "1984"));
+    bookSet.add(Book("8869183157", "Harry Potter and the Sorcerer's Stone"));
+    bookSet.add(Book("9780007203550", "The Lord of the Rings"));
+    assert(filter_view(bookSet, predicateBook()).count() == 2);
+    bookSet.retain_if(predicateBook());
+    ss << bookSet;
+    assert(ss.str() == "2 (9780151660346: 1984) (9780007203550: The Lord of the Rings)");
+    ss.str("");
+}
+
+/**
+ * @brief Funzione di hash per libri (per ISBN), coerente con funcBook.
+ */
+struct hashBook
+{
+    std::size_t operator()(const Book& book) const
+    {
+        return std::hash<std::string>()(book.getISBN());
+    }
+};
+
+/**
+ * @brief Test dell'unione di più set.
+ * 
+ * Test di union_all senza hash, con hash e in parallelo.
+ * 
+ */
+void testUnionAll()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test union_all ********" << std::endl;
+
+    std::vector<IntSet> shards(4);
+    int a[] = {5, 8, 1, 4};
+    int b[] = {4, 7, 765, 56, 65, 33, 1, 8};
+    int c[] = {100, 5};
+    shards[0] = IntSet(a, a + 4);
+    shards[1] = IntSet(b, b + 8);
+    shards[3] = IntSet(c, c + 2);
+
+    std::cout << "- Test union_all senza hash" << std::endl;
+    IntSet all = union_all(shards.begin(), shards.end());
+    std::cout << all << std::endl;
+    ss << all;
+    assert(ss.str() == "10 (5) (8) (1) (4) (7) (765) (56) (65) (33) (100)");
+    ss.str("");
+    assert(all.getCapacity() == 10);
+    assert(all == (shards[0] + shards[1]) + shards[3]);
+
+    std::cout << "- Test union_all con hash" << std::endl;
+    IntSet hashed = union_all(shards.begin(), shards.end(), std::hash<int>());
+    ss << hashed;
+    assert(ss.str() == "10 (5) (8) (1) (4) (7) (765) (56) (65) (33) (100)");
+    ss.str("");
+
+    std::cout << "- Test union_all in parallelo" << std::endl;
+    IntSet parallel = union_all(shards.begin(), shards.end(), std::hash<int>(), 3);
+    assert(parallel == all);
+
+    assert(union_all(shards.begin(), shards.begin()).getSize() == 0);
+
+    BookSet books[2];
+    books[0].add(Book("9780151660346", "1984"));
+    books[0].add(Book("978349803808", "To Kill a Mockingbird"));
+    books[1].add(Book("9780151660346", "1984"));
+    books[1].add(Book("1234", "AAAA"));
+    BookSet allBooks = union_all(books, books + 2, hashBook(), 2);
+    assert(allBooks == books[0] + books[1]);
+}
+
+/**
+ * @brief Test degli sketch probabilistici.
+ * 
+ * Test delle stime di cardinalità, unione, intersezione
+ * e similarità di Jaccard tra due set di interi.
+ * 
+ */
+void testSketch()
+{
+    std::cout << "******** Test sketch HyperLogLog e MinHash ********" << std::endl;
+
+    std::vector<int> va, vb;
+    for(int i = 0; i < 10000; i++)
+    {
+        va.push_back(i);
+        vb.push_back(i + 5000);
+    }
+    IntSet a(assume_unique, va.begin(), va.end());
+    IntSet b(assume_unique, vb.begin(), vb.end());
+
+    SetSketch<int> sa(a.begin(), a.end());
+    SetSketch<int> sb;
+    for(IntSet::const_iterator i = b.begin(); i != b.end(); ++i)
+    {
+        sb.add(*i);
+    }
+
+    double card = sa.estimate();
+    double uni = SetSketch<int>::union_estimate(sa, sb);
+    double inter = SetSketch<int>::intersection_estimate(sa, sb);
+    double jac = SetSketch<int>::jaccard(sa, sb);
+
+    std::cout << "|A| ~ " << card << ", |A u B| ~ " << uni << ", |A n B| ~ " << inter
+              << ", J ~ " << jac << std::endl;
+    assert(std::fabs(card - 10000) < 500);
+    assert(std::fabs(uni - 15000) < 750);
+    assert(std::fabs(inter - 5000) < 1000);
+    assert(std::fabs(jac - 1.0 / 3) < 0.1);
+
+    std::cout << "- Test merge degli sketch" << std::endl;
+    SetSketch<int> merged(sa);
+    merged.merge(sb);
+    assert(std::fabs(merged.estimate() - uni) < 1e-9);
+
+    HyperLogLog<int> small;
+    small.add(1);
+    small.add(2);
+    small.add(2);
+    assert(std::fabs(small.estimate() - 2) < 0.1);
+
+    std::cout << "- Test precisioni minime" << std::endl;
+    for(unsigned p = 4; p <= 7; p++)
+    {
+        HyperLogLog<int> coarse(a.begin(), a.end(), p);
+        std::cout << "p = " << p << ": |A| ~ " << coarse.estimate() << std::endl;
+        assert(std::fabs(coarse.estimate() - 10000) < 4000);
+    }
+
+    MinHash<int> ma(64), mb(64);
+    assert(ma.jaccard(mb) == 1.0);
+    ma.add(7);
+    mb.add(7);
+    assert(ma.jaccard(mb) == 1.0);
+}
+
+/**
+ * @brief Funtore che somma due interi (per parallel_reduce).
+ */
+struct sumLong
+{
+    long long operator()(long long a, long long b) const
+    {
+        return a + b;
+    }
+};
+
+/**
+ * @brief Funtore che converte un elemento nel valore 1 se soddisfa predicateBook.
+ */
+struct countBook
+{
+    long long operator()(const Book& book) const
+    {
+        return predicateBook()(book) ? 1 : 0;
+    }
+};
+
+/**
+ * @brief Test degli algoritmi paralleli.
+ * 
+ * Test di parallel_for_each e parallel_reduce su interi e libri,
+ * anche in presenza di slot rimossi in modo differito.
+ * 
+ */
+void testParallelo()
+{
+    std::cout << "******** Test parallel_for_each e parallel_reduce ********" << std::endl;
+
+    std::vector<int> values;
+    for(int i = 1; i <= 100000; i++)
+    {
+        values.push_back(i);
+    }
+    IntSet intSet(assume_unique, values.begin(), values.end());
+
+    std::cout << "- Test parallel_reduce (somma di 1..100000)" << std::endl;
+    long long sum = parallel_reduce(intSet, 0LL, [](int v) { return static_cast<long long>(v); }, sumLong(), 4, 100);
+    assert(sum == 5000050000LL);
+
+    std::cout << "- Test parallel_for_each (conteggio degli elementi > 5)" << std::endl;
+    std::atomic<long long> count(0);
+    parallel_for_each(intSet, [&count](int v) { if(predicateInt()(v)) count++; }, 3);
+    assert(count == 99995);
+
+    intSet.setCompactRatio(1);
+    intSet.remove(1);
+    intSet.remove(50000);
+    sum = parallel_reduce(intSet, 0LL, [](int v) { return static_cast<long long>(v); }, sumLong(), 4, 100);
+    assert(sum == 5000050000LL - 50001);
+
+    std::cout << "- Test parallel_reduce su libri (ISBN con più di 10 caratteri)" << std::endl;
+    std::vector<Book> books;
+    for(int i = 0; i < 10000; i++)
+    {
+        std::stringstream isbn;
+        isbn << (i % 2 == 0 ? 9788800000000LL + i : i); //ISBN di 13 cifre per i pari
+        books.push_back(Book(isbn.str(), "Titolo"));
+    }
+    BookSet bookSet(assume_unique, books.begin(), books.end());
+    long long longIsbn = parallel_reduce(bookSet, 0LL, countBook(), sumLong(), 4);
+    assert(longIsbn == 5000);
+    assert(parallel_reduce(bookSet, 0LL, [](const Book& b) { return static_cast<long long>(b.getISBN().size()); }, sumLong(), 2)
+           == parallel_reduce(bookSet, 0LL, [](const Book& b) { return static_cast<long long>(b.getISBN().size()); }, sumLong(), 1));
+}
+
+/**
+ * @brief Test di copia, assegnamento e rimozione.
+ * 
+ * Test della capacità esatta delle copie e delle copie di set vuoti
+ * o con un solo elemento, per tipi trivially copyable e non.
+ * 
+ */
+void testCopie()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test copie e spostamenti ********" << std::endl;
+
+    IntSet intSet;
+    for(int i = 0; i < 5; i++)
+    {
+        intSet.add(i);
+    }
+    assert(intSet.getCapacity() == 6);
+
+    std::cout << "- Test capacità del costruttore di copia" << std::endl;
+    IntSet copy(intSet);
+    assert(copy.getCapacity() == 5);
+    assert(copy == intSet);
+    copy.add(10);
+    ss << copy;
+    assert(ss.str() == "6 (0) (1) (2) (3) (4) (10)");
+    ss.str("");
+
+    std::cout << "- Test copia di set vuoti e con un elemento" << std::endl;
+    IntSet emptySet;
+    IntSet emptyCopy(emptySet);
+    emptyCopy.add(1);
+    emptyCopy.add(2);
+    IntSet assigned;
+    assigned = emptySet;
+    assigned.add(3);
+    IntSet single(assigned);
+    assert(single.getCapacity() == 1);
+    single.add(4);
+    single.add(5);
+    ss << single;
+    assert(ss.str() == "3 (3) (4) (5)");
+    ss.str("");
+
+    std::cout << "- Test assegnamento con riuso del buffer" << std::endl;
+    copy = assigned;
+    assert(copy.getCapacity() == 7);
+    assert(copy == assigned);
+
+    std::cout << "- Test spostamento" << std::endl;
+    static_assert(std::is_nothrow_move_constructible<IntSet>::value &&
+                  std::is_nothrow_move_assignable<StringSet>::value,
+                  "Lo spostamento di un Set non deve sollevare eccezioni");
+    std::vector<StringSet> shards(1);
+    shards[0].add("E");
+    const std::string* first = &*shards[0].begin();
+    shards.resize(shards.capacity() + 1); //Riallocazione: i set vengono spostati, non copiati
+    assert(&*shards[0].begin() == first);
+    IntSet moved(std::move(copy));
+    assert(moved.getCapacity() == 7 && moved == assigned);
+    assert(copy.getSize() == 0 && copy.getCapacity() == 0);
+    copy = std::move(moved);
+    assert(copy == assigned && moved.getSize() == 0);
+    moved.add(1);
+    assert(moved.contains(1));
+
+    StringSet strings;
+    strings.add("E");
+    strings.add("H");
+    strings.add("A");
+    strings.add("D");
+    strings.remove("E");
+    StringSet stringsCopy(strings);
+    stringsCopy.add("Z");
+    stringsCopy.remove("A");
+    ss << strings << " " << stringsCopy;
+    assert(ss.str() == "3 (H) (A) (D) 3 (H) (D) (Z)");
+    ss.str("");
+}
+
+struct funcBookTransparent
+{
+    typedef void is_transparent;
+
+    bool operator()(const Book& a, const Book& b) const
+    {
+        return a.getISBN() == b.getISBN();
+    }
+
+    bool operator()(const Book& a, const std::string& isbn) const
+    {
+        return a.getISBN() == isbn;
+    }
+};
+
+struct funcStrTransparent
+{
+    typedef void is_transparent;
+
+    bool operator()(const std::string& a, const std::string& b) const
+    {
+        return a == b;
+    }
+
+    bool operator()(const std::string& a, const char* b) const
+    {
+        return a.compare(b) == 0;
+    }
+};
+
+/**
+ * @brief Test della ricerca con chiavi eterogenee.
+ * 
+ * Test di contains, find e remove con funtori trasparenti,
+ * senza costruire un elemento temporaneo per la ricerca.
+ * 
+ */
+void testRicercaEterogenea()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test ricerca eterogenea ********" << std::endl;
+
+    Set<Book, funcBookTransparent> bookSet;
+    bookSet.add(Book("9788804668237", "Il nome della rosa"));
+    bookSet.add(Book("9788806219352", "Se questo è un uomo"));
+    bookSet.add(Book("9788845292613", "Il signore degli anelli"));
+
+    std::cout << "- Test contains e find tramite ISBN" << std::endl;
+    assert(bookSet.contains(std::string("9788806219352")));
+    assert(!bookSet.contains(std::string("0000000000000")));
+    assert(bookSet.contains(Book("9788804668237", "")));
+
+    Set<Book, funcBookTransparent>::const_iterator it = bookSet.find(std::string("9788845292613"));
+    assert(it != bookSet.end());
+    assert(it->getTitle() == "Il signore degli anelli");
+    assert(bookSet.find(std::string("0000000000000")) == bookSet.end());
+
+    std::cout << "- Test remove tramite ISBN con rimozione differita" << std::endl;
+    bookSet.setCompactRatio(0.9);
+    assert(bookSet.remove(std::string("9788804668237")));
+    assert(!bookSet.remove(std::string("9788804668237")));
+    assert(bookSet.find(std::string("9788804668237")) == bookSet.end());
+    it = bookSet.find(std::string("9788806219352"));
+    ++it;
+    assert(it->getTitle() == "Il signore degli anelli");
+    ++it;
+    assert(it == bookSet.end());
+    assert(bookSet.getSize() == 2);
+
+    std::cout << "- Test ricerca con const char*" << std::endl;
+    Set<std::string, funcStrTransparent> stringSet;
+    stringSet.add("E");
+    stringSet.add("H");
+    stringSet.add("A");
+    assert(stringSet.contains("H"));
+    assert(!stringSet.contains("Z"));
+    assert(*stringSet.find("A") == "A");
+    assert(stringSet.remove("E"));
+    ss << stringSet;
+    assert(ss.str() == "2 (H) (A)");
+    ss.str("");
+
+    std::cout << "- Test find con funtore non trasparente" << std::endl;
+    IntSet intSet;
+    intSet.add(3);
+    intSet.add(7);
+    assert(*intSet.find(7) == 7);
+    assert(intSet.find(5) == intSet.end());
+}
+
+struct parseBook
+{
+    // Record nel formato "ISBN;titolo", le righe vuote vengono scartate
+    bool operator()(const char* begin, const char* end, Book& out) const
+    {
+        if(begin == end)
+            return false;
+
+        const char* sep = std::find(begin, end, ';');
+        if(sep == end)
+            throw std::runtime_error("Record non valido");
+
+        out = Book(std::string(begin, sep), std::string(sep + 1, end));
+        return true;
+    }
+};
+
+/**
+ * @brief Test della costruzione di set da stream.
+ * 
+ * Test con blocchi piccoli (record spezzati tra blocchi),
+ * con uno e più thread, da file e con errori di parsing.
+ * 
+ */
+void testStream()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test costruzione da stream ********" << std::endl;
+
+    std::cout << "- Test di stringhe con un thread" << std::endl;
+    std::istringstream lines("a\nb\na\nc\nb\nc");
+    StringSet strings = stream_build<std::string, funcStr>(lines, LineParser(), std::hash<std::string>(), 1, 3);
+    ss << strings;
+    assert(ss.str() == "3 (a) (b) (c)");
+    ss.str("");
+
+    std::cout << "- Test di Book da file con più thread" << std::endl;
+    {
+        std::ofstream file("streamBooks.txt");
+        for(int i = 0; i < 2000; i++)
+        {
+            file << "978" << (i % 700) << ";Titolo " << (i % 700) << '\n';
+            if(i % 100 == 0)
+                file << '\n';
+        }
+    }
+
+    Set<Book, funcBook> sequential = stream_build<Book, funcBook>("streamBooks.txt", parseBook(), hashBook(), 1, 64);
+    Set<Book, funcBook> parallel = stream_build<Book, funcBook>("streamBooks.txt", parseBook(), hashBook(), 4, 64, 2);
+    assert(sequential.getSize() == 700);
+    assert(sequential == parallel);
+    assert(sequential[0].getISBN() == "9780");
+    assert(parallel.contains(Book("978699", "")));
+    assert(!parallel.contains(Book("978700", "")));
+
+    std::cout << "- Test di errori di parsing e di apertura" << std::endl;
+    std::istringstream invalid("9781;A\nsenza separatore\n9782;B\n");
+    bool thrown = false;
+    try
+    {
+        stream_build<Book, funcBook>(invalid, parseBook(), hashBook(), 2, 4);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try
+    {
+        stream_build<Book, funcBook>("fileInesistente.txt", parseBook(), hashBook());
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::remove("streamBooks.txt");
+}
+
+/**
+ * @brief Test della crescita della capacità vicino al massimo.
+ * 
+ * Test della crescita con tipi di dimensione piccoli,
+ * che non deve mai ricominciare da un valore più piccolo.
+ * 
+ */
+void testCapacitaMassima()
+{
+    std::cout << "******** Test capacità massima ********" << std::endl;
+
+    std::cout << "- Test crescita limitata al massimo" << std::endl;
+    assert(gset_detail::grow_capacity<unsigned int>(0, 100) == 2);
+    assert(gset_detail::grow_capacity<unsigned int>(6, 100) == 9);
+    assert(gset_detail::grow_capacity<unsigned char>(170, 255) == 255);
+    assert(gset_detail::grow_capacity<unsigned int>(4000000000u, 4294967295u) == 4294967295u);
+
+    std::cout << "- Test crescita oltre il massimo" << std::endl;
+    bool thrown = false;
+    try
+    {
+        gset_detail::grow_capacity<unsigned char>(255, 255);
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "- Test set pieno con size_type di 8 bit" << std::endl;
+    Set<int, funcInt, unsigned char> tiny;
+    for(int i = 0; i < 255; i++)
+    {
+        tiny.add(i);
+    }
+    thrown = false;
+    try
+    {
+        tiny.add(255);
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(tiny.getSize() == 255 && tiny.contains(0) && tiny.contains(254) && !tiny.contains(255));
+    assert(intersection_size(tiny, tiny) == 255);
+
+    std::cout << "- Test operazioni su set con size_type non di default" << std::endl;
+    Set<int, funcInt, unsigned char> evens;
+    for(int i = 0; i < 10; i += 2)
+    {
+        evens.add(i);
+    }
+    Set<int, funcInt, unsigned char> common = tiny - evens;
+    assert(common.getSize() == 5 && common.contains(8));
+    auto view = filter_view(evens, predicateInt());
+    assert(view.count() == 2);
+    assert(filter_out(evens, predicateInt()).getSize() == 2);
+
+    Set<int, funcInt, unsigned char> low, high;
+    for(int i = 0; i < 200; i++)
+    {
+        low.add(i);
+        high.add(1000 + i);
+    }
+    assert(union_size(low, evens) == 200);
+    thrown = false;
+    try
+    {
+        union_size(low, high);
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    Set<int, funcInt, std::uint64_t> wide, wideOther;
+    for(int i = 0; i < 10; i++)
+    {
+        wide.add(i);
+        wideOther.add(i + 5);
+    }
+    assert((wide - wideOther).getSize() == 5);
+    assert((wide + wideOther).getSize() == 15);
+    assert(filter_view(wide, predicateInt()).count() == 4);
+
+    std::cout << "- Test set con buffer di grandi dimensioni" << std::endl;
+    std::vector<int> values(1000000);
+    for(int i = 0; i < 1000000; i++)
+    {
+        values[i] = i;
+    }
+    IntSet large(assume_unique, values.begin(), values.end());
+    assert(large.getSize() == 1000000);
+    assert(large.contains(999999));
+    large.add(-1);
+    assert(large[1000000] == -1);
+    IntSet largeCopy(large);
+    assert(largeCopy.getSize() == large.getSize());
+    assert(largeCopy[500000] == 500000);
+}
+
+/**
+ * @brief Test di cardinalità e relazioni tra set.
+ * 
+ * Test di intersection_size, union_size, is_subset_of e is_disjoint
+ * su tutti i tipi di set, confrontati con le dimensioni di operator-.
+ * 
+ */
+void testCardinalita()
+{
+    std::cout << "******** Test cardinalità senza materializzazione ********" << std::endl;
+
+    std::cout << "- Test su Set" << std::endl;
+    IntSet a, b, c;
+    for(int i = 0; i < 50; i++)
+    {
+        a.add(i);
+        if(i % 5 == 0)
+            b.add(i);
+        c.add(100 + i);
+    }
+    b.add(500);
+    assert(intersection_size(a, b) == (a - b).getSize());
+    assert(intersection_size(a, b) == 10);
+    assert(union_size(a, b) == (a + b).getSize());
+    assert(!is_subset_of(b, a));
+    b.remove(500);
+    assert(is_subset_of(b, a));
+    assert(!is_subset_of(a, b));
+    assert(is_disjoint(a, c));
+    assert(!is_disjoint(a, b));
+    assert(is_subset_of(IntSet(), a));
+    assert(intersection_size(a, IntSet()) == 0);
+
+    std::cout << "- Test su BitmapSet" << std::endl;
+    typedef BitmapSet<int, -10, 200> ShardSet;
+    ShardSet sa, sb, sc;
+    for(int i = -10; i <= 200; i += 2)
+    {
+        sa.add(i);
+    }
+    for(int i = -10; i <= 200; i += 6)
+    {
+        sb.add(i);
+    }
+    sc.add(-9);
+    sc.add(199);
+    assert(intersection_size(sa, sb) == (sa - sb).getSize());
+    assert(union_size(sa, sb) == (sa + sb).getSize());
+    assert(is_subset_of(sb, sa));
+    assert(!is_subset_of(sa, sb));
+    assert(is_disjoint(sa, sc));
+    sc.add(0);
+    assert(!is_disjoint(sa, sc));
+
+    std::cout << "- Test su SortedSet" << std::endl;
+    SortedSet<int> oa, ob, oc;
+    for(int i = 0; i < 1000; i++)
+    {
+        oa.add(i);
+    }
+    ob.add(7);
+    ob.add(500);
+    ob.add(999);
+    oc.add(-1);
+    oc.add(1000);
+    assert(intersection_size(oa, ob) == 3);
+    assert(intersection_size(ob, oa) == (ob - oa).getSize());
+    assert(union_size(oa, ob) == 1000);
+    assert(is_subset_of(ob, oa));
+    ob.add(1001);
+    assert(!is_subset_of(ob, oa));
+    assert(is_disjoint(oa, oc));
+    assert(!is_disjoint(ob, oa));
+    SortedSet<int> even;
+    for(int i = 0; i < 1000; i += 2)
+    {
+        even.add(i);
+    }
+    assert(intersection_size(oa, even) == 500);
+    assert(is_subset_of(even, oa));
+
+    std::cout << "- Test su CompressedSet" << std::endl;
+    CompressedSet ca, cb, cr;
+    for(std::uint32_t i = 0; i < 200000; i += 3)
+    {
+        ca.add(i);
+    }
+    for(std::uint32_t i = 0; i < 200000; i += 7)
+    {
+        cb.add(i);
+    }
+    for(std::uint32_t i = 60000; i < 140000; i++)
+    {
+        cr.add(i);
+    }
+    cr.runOptimize();
+    assert(intersection_size(ca, cb) == (ca - cb).getSize());
+    assert(intersection_size(cr, ca) == (cr - ca).getSize());
+    assert(intersection_size(cb, cr) == (cb - cr).getSize());
+    assert(union_size(ca, cr) == (ca + cr).getSize());
+    CompressedSet cr2;
+    for(std::uint32_t i = 100000; i < 150000; i++)
+    {
+        cr2.add(i);
+    }
+    cr2.runOptimize();
+    assert(intersection_size(cr, cr2) == 40000);
+    assert(!is_subset_of(cr2, cr));
+    assert(is_subset_of(ca - cb, ca));
+    assert(!is_subset_of(ca, cb));
+    CompressedSet far;
+    far.add(1u << 30);
+    assert(is_disjoint(ca, far));
+    assert(!is_disjoint(ca, cr));
+}
+
+// Memoria allocata da un Book, trovata tramite ADL da Set::memory_usage
+std::size_t heap_usage(const Book& book)
+{
+    return gset_detail::heap_usage(book.getISBN()) + gset_detail::heap_usage(book.getTitle()) +
+           gset_detail::heap_usage(book.getAuthors());
+}
+
+/**
+ * @brief Elemento il cui costruttore di default può fallire.
+ */
+struct Fragile
+{
+    static bool failing;
+    int value;
+
+    Fragile() : value(0)
+    {
+        if(failing)
+            throw std::runtime_error("Costruzione fallita");
+    }
+    Fragile(int v) : value(v) {}
+};
+bool Fragile::failing = false;
+
+struct funcFragile
+{
+    bool operator()(const Fragile& a, const Fragile& b) const { return a.value == b.value; }
+};
+
+/**
+ * @brief Test della gestione della memoria.
+ * 
+ * Test di memory_usage, reserve, shrink_to_fit
+ * e della politica di crescita e riduzione della capacità.
+ * 
+ */
+void testMemoria()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test gestione della memoria ********" << std::endl;
+
+    std::cout << "- Test riduzione automatica dopo rimozioni" << std::endl;
+    IntSet intSet;
+    for(int i = 0; i < 1000; i++)
+    {
+        intSet.add(i);
+    }
+    IntSet::size_type peak = intSet.getCapacity();
+    for(int i = 0; i < 950; i++)
+    {
+        intSet.remove(i);
+    }
+    assert(intSet.getCapacity() < peak / 4);
+    assert(intSet.getCapacity() >= intSet.getSize());
+    assert(intSet[0] == 950 && intSet[49] == 999);
+
+    std::cout << "- Test isteresi" << std::endl;
+    IntSet::size_type shrunk = intSet.getCapacity();
+    for(int i = 0; i < 10; i++)
+    {
+        intSet.add(5000);
+        intSet.remove(5000);
+    }
+    assert(intSet.getCapacity() == shrunk);
+
+    std::cout << "- Test riduzione disattivata e con rimozione differita" << std::endl;
+    IntSet keep;
+    keep.setShrinkRatio(0);
+    IntSet lazy;
+    lazy.setCompactRatio(0.5);
+    for(int i = 0; i < 200; i++)
+    {
+        keep.add(i);
+        lazy.add(i);
+    }
+    peak = keep.getCapacity();
+    for(int i = 0; i < 190; i++)
+    {
+        keep.remove(i);
+        lazy.remove(i);
+    }
+    assert(keep.getCapacity() == peak);
+    assert(lazy.getCapacity() < peak);
+    ss << lazy;
+    assert(ss.str() == "10 (190) (191) (192) (193) (194) (195) (196) (197) (198) (199)");
+    ss.str("");
+
+    std::cout << "- Test reserve e shrink_to_fit" << std::endl;
+    IntSet reserved;
+    reserved.reserve(500);
+    assert(reserved.getCapacity() == 500);
+    for(int i = 0; i < 500; i++)
+    {
+        reserved.add(i);
+    }
+    assert(reserved.getCapacity() == 500);
+    keep.shrink_to_fit();
+    assert(keep.getCapacity() == 10);
+    assert(keep.contains(195));
+    keep.empty();
+    keep.add(1);
+    keep.remove(1);
+    keep.shrink_to_fit();
+    assert(keep.getCapacity() == 0);
+
+    std::cout << "- Test fattore di crescita" << std::endl;
+    IntSet doubling;
+    doubling.setGrowthFactor(2);
+    for(int i = 0; i < 5; i++)
+    {
+        doubling.add(i);
+    }
+    assert(doubling.getCapacity() == 8);
+    bool thrown = false;
+    try
+    {
+        doubling.setGrowthFactor(1);
+    }
+    catch(const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try
+    {
+        doubling.setShrinkRatio(0.5);
+    }
+    catch(const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "- Test memory_usage" << std::endl;
+    assert(reserved.memory_usage() == sizeof(IntSet) + 500 * sizeof(int));
+
+    StringSet shortStrings, longStrings;
+    shortStrings.add("a");
+    longStrings.add(std::string(100, 'x'));
+    assert(shortStrings.memory_usage() == sizeof(StringSet) + shortStrings.getCapacity() * sizeof(std::string));
+    assert(longStrings.memory_usage() >= sizeof(StringSet) + longStrings.getCapacity() * sizeof(std::string) + 100);
+
+    Set<Book, funcBook> books;
+    books.add(Book("9788804668237", "Il nome della rosa: un romanzo di Umberto Eco", {"Umberto Eco"}));
+    assert(books.memory_usage() > sizeof(books) + books.getCapacity() * sizeof(Book) + 40);
+
+    std::cout << "- Test riduzione con errore non di allocazione" << std::endl;
+    Set<Fragile, funcFragile> fragile;
+    for(int i = 0; i < 100; i++)
+    {
+        fragile.add(Fragile(i));
+    }
+    peak = fragile.getCapacity();
+    Fragile::failing = true;
+    for(int i = 0; i < 90; i++)
+    {
+        assert(fragile.remove(Fragile(i)));
+    }
+    assert(fragile.retain_if([](const Fragile& f) { return f.value != 95; }) == 1);
+    Fragile::failing = false;
+    assert(fragile.getCapacity() == peak);
+    assert(fragile.getSize() == 9 && fragile[0].value == 90 && fragile[8].value == 99);
+}
+
+#ifndef _WIN32
+/**
+ * @brief Test del set persistente mappato in memoria.
+ * 
+ * Test di inserimento, rimozione, sync e riapertura del file.
+ * 
+ */
+void testMappedSet()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test set mappato in memoria ********" << std::endl;
+
+    std::remove("mappedSet.bin");
+    {
+        MappedSet<int, funcInt> mapped("mappedSet.bin");
+        std::cout << "- Test add degli elementi: { 5, 8, 8, 1, 4 }" << std::endl;
+        mapped.add(5);
+        mapped.add(8);
+        assert(mapped.add(8) == false);
+        mapped.add(1);
+        mapped.add(4);
+        assert(mapped.getCapacity() == 4);
+        assert(mapped.remove(8));
+        assert(mapped.remove(8) == false);
+        mapped.sync();
+    }
+
+    std::cout << "- Test riapertura del file" << std::endl;
+    bool thrown = false;
+    {
+        MappedSet<int, funcInt> reopened("mappedSet.bin");
+        std::cout << reopened << std::endl;
+        ss << reopened;
+        assert(ss.str() == "3 (5) (1) (4)");
+        ss.str("");
+        assert(reopened.contains(4));
+        assert(reopened[1] == 1);
+
+        std::cout << "- Test apertura concorrente (lock esclusivo)" << std::endl;
+        try
+        {
+            MappedSet<int, funcInt> second("mappedSet.bin");
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+
+        reopened.empty();
+        assert(reopened.getSize() == 0);
+        reopened.add(7);
+        ss << reopened;
+        assert(ss.str() == "1 (7)");
+        ss.str("");
+    }
+
+    thrown = false;
+    try
+    {
+        MappedSet<double, std::equal_to<double> > wrongType("mappedSet.bin");
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    {
+        MappedSet<int, funcInt> afterClose("mappedSet.bin"); //Il lock viene rilasciato alla distruzione
+        assert(afterClose.getSize() == 1 && afterClose.contains(7));
+    }
+
+    std::cout << "- Test intestazione con capacità non valida" << std::endl;
+    {
+        std::fstream file("mappedSet.bin", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(24);
+        std::uint64_t capacity = std::uint64_t(1) << 62;
+        file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+    }
+    thrown = false;
+    try
+    {
+        MappedSet<int, funcInt> corrupt("mappedSet.bin");
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    std::remove("mappedSet.bin");
+}
+/**
+ * @brief Test del set con registro delle modifiche.
+ * 
+ * Test di commit a gruppi, ripristino da registro,
+ * compattazione in background e record incompleti.
+ * 
+ */
+void testJournaledSet()
+{
+    std::stringstream ss;
+
+    std::cout << "******** Test set con registro delle modifiche ********" << std::endl;
+
+    std::remove("journal.snap");
+    std::remove("journal.log");
+    std::remove("journal.log.old");
+
+    {
+        JournaledSet<funcStr> journal("journal", 2);
+        std::cout << "- Test add degli elementi: {E, H, H, A} e remove di {H}" << std::endl;
+        journal.add("E");
+        journal.add("H");
+        assert(journal.add("H") == false);
+        journal.add("A");
+        journal.remove("H");
+    }
+
+    std::cout << "- Test ripristino dal registro" << std::endl;
+    {
+        JournaledSet<funcStr> journal("journal");
+        std::cout << journal.getSet() << std::endl;
+        ss << journal.getSet();
+        assert(ss.str() == "2 (E) (A)");
+        ss.str("");
+
+        std::cout << "- Test compattazione in uno snapshot" << std::endl;
+        journal.compact();
+        journal.add("D");
+        journal.waitCompaction();
+        journal.commit();
+    }
+
+    std::ifstream snap("journal.snap");
+    ss << snap.rdbuf();
+    assert(ss.str() == "E\nA\n");
+    ss.str("");
+
+    {
+        // Record finale incompleto (scrittura interrotta)
+        std::ofstream log("journal.log", std::ios::app);
+        log << "+Z";
+    }
+
+    JournaledSet<funcStr> journal("journal");
+    ss << journal.getSet();
+    assert(ss.str() == "3 (E) (A) (D)");
+    ss.str("");
+    journal.add("K");
+    journal.commit();
+
+    JournaledSet<funcStr> reopened("journal");
+    assert(reopened.contains("K"));
+    assert(!reopened.contains("Z"));
+
+    std::cout << "- Test compattazione dopo una compattazione fallita" << std::endl;
+    std::remove("journal.snap");
+    std::remove("journal.log");
+    {
+        JournaledSet<funcStr> failing("journal");
+        failing.add("A");
+        failing.add("B");
+
+        // Una directory al posto dello snapshot fa fallire la rinomina
+        ::mkdir("journal.snap", 0755);
+        std::ofstream("journal.snap/x");
+        for(int round = 0; round < 2; round++)
+        {
+            failing.compact();
+            failing.add(round == 0 ? "C" : "D");
+            failing.commit();
+            bool thrown = false;
+            try
+            {
+                failing.waitCompaction();
+            }
+            catch(const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+    }
+    std::remove("journal.snap/x");
+    std::remove("journal.snap");
+
+    {
+        // ".log.old" conserva i record di entrambe le compattazioni fallite
+        JournaledSet<funcStr> restored("journal");
+        ss << restored.getSet();
+        assert(ss.str() == "4 (A) (B) (C) (D)");
+        ss.str("");
+    }
+
+    std::remove("journal.snap");
+    std::remove("journal.snap.tmp");
+    std::remove("journal.log");
+    std::remove("journal.log.old");
+}
+#endif
+
 
 int main()
 {
@@ -530,5 +2070,39 @@ int main()
     testMetodiGlobali();
 
     testSave();
+    std::cout << "\n\n";
+    testBitmapSet();
+    std::cout << "\n\n";
+    testCompressedSet();
+    std::cout << "\n\n";
+    testSortedSet();
+    std::cout << "\n\n";
+    testRimozioneDifferita();
+    std::cout << "\n\n";
+    testViste();
+    std::cout << "\n\n";
+    testUnionAll();
+    std::cout << "\n\n";
+    testSketch();
+    std::cout << "\n\n";
+    testParallelo();
+    std::cout << "\n\n";
+    testCopie();
+    std::cout << "\n\n";
+    testRicercaEterogenea();
+    std::cout << "\n\n";
+    testStream();
+    std::cout << "\n\n";
+    testCapacitaMassima();
+    std::cout << "\n\n";
+    testCardinalita();
+    std::cout << "\n\n";
+    testMemoria();
+#ifndef _WIN32
+    std::cout << "\n\n";
+    testMappedSet();
+    std::cout << "\n\n";
+    testJournaledSet();
+#endif
     return 0;
 }
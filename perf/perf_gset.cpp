@@ -0,0 +1,398 @@
+/**
+ * @file perf_gset.cpp
+ *
+ * @brief Test di regressione delle prestazioni.
+ *
+ * Esegue carichi di lavoro fissi sui set, ne verifica i risultati
+ * rispetto a std::unordered_set e confronta il throughput
+ * (operazioni al secondo) con un file di riferimento.
+ *
+ * Uso: GSetPerf <baseline> [--update] [--tolerance t]
+ * - senza --update il programma fallisce se un carico di lavoro
+ *   scende sotto (1 - t) volte il valore di riferimento (default t = 0.5,
+ *   sovrascrivibile anche con la variabile d'ambiente GSET_PERF_TOLERANCE);
+ * - con --update il file di riferimento viene riscritto con i valori misurati.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "gset.hpp"
+#include "gset_bitmap.hpp"
+#include "gset_compressed.hpp"
+#include "gset_sorted.hpp"
+
+struct funcInt
+{
+    bool operator()(int a, int b) const
+    {
+        return a == b;
+    }
+};
+
+struct funcStr
+{
+    bool operator()(const std::string& a, const std::string& b) const
+    {
+        return a == b;
+    }
+};
+
+typedef Set<int, funcInt> IntSet;
+typedef Set<std::string, funcStr> StringSet;
+typedef BitmapSet<int, 0, (1 << 20) - 1> WideBitmap;
+
+const int REPEAT = 5;                   //Ripetizioni di ogni misura (si tiene la migliore)
+const double MIN_SECONDS = 0.05;        //Durata minima di una misura
+const std::size_t LINEAR_N = 4000;      //Elementi di Set, la cui ricerca è lineare
+const std::size_t LINEAR_LOOKUPS = 100000;
+const std::size_t FAST_N = 100000;      //Elementi dei set con ricerca sublineare
+const std::size_t FAST_LOOKUPS = 1000000;
+const int UNIVERSE = 1 << 20;           //Valori generati in [0, UNIVERSE)
+
+static bool gFailed = false;
+static volatile std::size_t gSink = 0;  //Impedisce al compilatore di eliminare i carichi di lavoro
+
+/**
+ * @brief Registra il fallimento di un controllo differenziale.
+ */
+static void check(bool condition, const std::string& what)
+{
+    if(!condition)
+    {
+        std::cerr << "ERRORE: risultato diverso da std::unordered_set in " << what << std::endl;
+        gFailed = true;
+    }
+}
+
+/**
+ * @brief Throughput di un carico di lavoro.
+ *
+ * Ogni misura ripete work fino a coprire almeno MIN_SECONDS,
+ * così che i carichi di lavoro brevi non dipendano dalla
+ * risoluzione del timer.
+ *
+ * @param ops Numero di operazioni eseguite da una chiamata di work.
+ * @param work Carico di lavoro.
+ * @return double Operazioni al secondo della migliore tra REPEAT misure.
+ */
+template<typename F>
+static double measure(std::size_t ops, F work)
+{
+    double best = 0;
+    for(int r = 0; r < REPEAT; r++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed(0);
+        std::size_t calls = 0;
+        do
+        {
+            work();
+            calls++;
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        while(elapsed.count() < MIN_SECONDS);
+
+        double rate = static_cast<double>(ops) * static_cast<double>(calls) / elapsed.count();
+        best = std::max(best, rate);
+    }
+
+    return best;
+}
+
+static std::vector<int> randomValues(std::size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, UNIVERSE - 1);
+    std::vector<int> values(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        values[i] = dist(gen);
+    }
+    return values;
+}
+
+template<typename S>
+static std::size_t countHits(const S& set, const std::vector<int>& probes, std::size_t n)
+{
+    std::size_t hits = 0;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        if(set.contains(probes[i]))
+            hits++;
+    }
+    return hits;
+}
+
+static std::size_t countHits(const std::unordered_set<int>& set, const std::vector<int>& probes, std::size_t n)
+{
+    std::size_t hits = 0;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        hits += set.count(probes[i]);
+    }
+    return hits;
+}
+
+template<typename S>
+static std::unordered_set<int> toReference(const S& set)
+{
+    std::unordered_set<int> res;
+    for(typename S::const_iterator i = set.begin(); i != set.end(); ++i)
+    {
+        res.insert(static_cast<int>(*i));
+    }
+    return res;
+}
+
+static std::size_t referenceIntersection(const std::unordered_set<int>& a, const std::unordered_set<int>& b)
+{
+    std::size_t n = 0;
+    for(std::unordered_set<int>::const_iterator i = a.begin(); i != a.end(); ++i)
+    {
+        n += b.count(*i);
+    }
+    return n;
+}
+
+struct hashInt
+{
+    std::size_t operator()(int v) const { return std::hash<int>()(v); }
+};
+
+/**
+ * @brief Esegue tutti i carichi di lavoro.
+ *
+ * @return Throughput per nome del carico di lavoro.
+ */
+static std::map<std::string, double> runWorkloads()
+{
+    std::map<std::string, double> res;
+
+    const std::vector<int> valuesA = randomValues(FAST_N, 1);
+    const std::vector<int> valuesB = randomValues(FAST_N, 2);
+    const std::vector<int> probes = randomValues(FAST_LOOKUPS, 3);
+    const std::unordered_set<int> refA(valuesA.begin(), valuesA.end());
+    const std::unordered_set<int> refB(valuesB.begin(), valuesB.end());
+    const std::unordered_set<int> refSmallA(valuesA.begin(), valuesA.begin() + LINEAR_N);
+    const std::unordered_set<int> refSmallB(valuesB.begin(), valuesB.begin() + LINEAR_N);
+
+    // Set: costruzione, ricerca, unione e intersezione a dimensione ridotta
+    IntSet smallA, smallB;
+    res["set_build"] = measure(LINEAR_N, [&]()
+    {
+        smallA.empty();
+        for(std::size_t i = 0; i < LINEAR_N; i++)
+        {
+            smallA.add(valuesA[i]);
+        }
+    });
+    smallB = IntSet(valuesB.begin(), valuesB.begin() + LINEAR_N);
+    check(smallA.getSize() == refSmallA.size(), "set_build");
+
+    std::size_t hits = 0;
+    res["set_contains"] = measure(LINEAR_LOOKUPS, [&]() { hits = countHits(smallA, probes, LINEAR_LOOKUPS); });
+    check(hits == countHits(refSmallA, probes, LINEAR_LOOKUPS), "set_contains");
+
+    std::size_t unionSize = 0, interSize = 0;
+    res["set_union"] = measure(2 * LINEAR_N, [&]() { unionSize = (smallA + smallB).getSize(); });
+    res["set_intersection"] = measure(2 * LINEAR_N, [&]() { interSize = (smallA - smallB).getSize(); });
+    check(interSize == referenceIntersection(refSmallA, refSmallB), "set_intersection");
+    check(unionSize == refSmallA.size() + refSmallB.size() - interSize, "set_union");
+
+    // Set: unione di insiemi grandi tramite hash
+    IntSet largeA(assume_unique, refA.begin(), refA.end());
+    IntSet largeB(assume_unique, refB.begin(), refB.end());
+    IntSet inputs[] = {largeA, largeB};
+    res["set_union_all_hash"] = measure(2 * FAST_N, [&]() { unionSize = union_all(inputs, inputs + 2, hashInt()).getSize(); });
+    std::size_t refInter = referenceIntersection(refA, refB);
+    check(unionSize == refA.size() + refB.size() - refInter, "set_union_all_hash");
+
+    // SortedSet
+    SortedSet<int> sortedA, sortedB(valuesB.begin(), valuesB.end());
+    res["sorted_build"] = measure(FAST_N, [&]()
+    {
+        sortedA.empty();
+        sortedA.add(valuesA.begin(), valuesA.end());
+    });
+    check(sortedA.getSize() == refA.size(), "sorted_build");
+    res["sorted_contains"] = measure(FAST_LOOKUPS, [&]() { hits = countHits(sortedA, probes, FAST_LOOKUPS); });
+    check(hits == countHits(refA, probes, FAST_LOOKUPS), "sorted_contains");
+    res["sorted_union"] = measure(2 * FAST_N, [&]() { unionSize = (sortedA + sortedB).getSize(); });
+    res["sorted_intersection"] = measure(2 * FAST_N, [&]() { interSize = (sortedA - sortedB).getSize(); });
+    check(interSize == refInter, "sorted_intersection");
+    check(unionSize == refA.size() + refB.size() - refInter, "sorted_union");
+
+    // CompressedSet
+    CompressedSet compA, compB;
+    res["compressed_build"] = measure(FAST_N, [&]()
+    {
+        compA.empty();
+        for(std::size_t i = 0; i < FAST_N; i++)
+        {
+            compA.add(static_cast<std::uint32_t>(valuesA[i]));
+        }
+    });
+    for(std::size_t i = 0; i < FAST_N; i++)
+    {
+        compB.add(static_cast<std::uint32_t>(valuesB[i]));
+    }
+    check(compA.getSize() == refA.size(), "compressed_build");
+    res["compressed_contains"] = measure(FAST_LOOKUPS, [&]()
+    {
+        hits = 0;
+        for(std::size_t i = 0; i < FAST_LOOKUPS; i++)
+        {
+            if(compA.contains(static_cast<std::uint32_t>(probes[i])))
+                hits++;
+        }
+    });
+    check(hits == countHits(refA, probes, FAST_LOOKUPS), "compressed_contains");
+    res["compressed_union"] = measure(2 * FAST_N, [&]() { unionSize = static_cast<std::size_t>((compA + compB).getSize()); });
+    res["compressed_intersection"] = measure(2 * FAST_N, [&]() { interSize = static_cast<std::size_t>((compA - compB).getSize()); });
+    check(interSize == refInter, "compressed_intersection");
+    check(unionSize == refA.size() + refB.size() - refInter, "compressed_union");
+
+    // BitmapSet
+    WideBitmap bitsA(valuesA.begin(), valuesA.end()), bitsB(valuesB.begin(), valuesB.end());
+    check(toReference(bitsA) == refA, "bitmap_build");
+    res["bitmap_contains"] = measure(FAST_LOOKUPS, [&]() { hits = countHits(bitsA, probes, FAST_LOOKUPS); });
+    check(hits == countHits(refA, probes, FAST_LOOKUPS), "bitmap_contains");
+    res["bitmap_union"] = measure(2 * FAST_N, [&]() { unionSize = (bitsA + bitsB).getSize(); });
+    res["bitmap_intersection"] = measure(2 * FAST_N, [&]() { interSize = (bitsA - bitsB).getSize(); });
+    check(interSize == refInter, "bitmap_intersection");
+    check(unionSize == refA.size() + refB.size() - refInter, "bitmap_union");
+
+    // Salvataggio e ricaricamento
+    StringSet strings;
+    for(std::size_t i = 0; i < LINEAR_N; i++)
+    {
+        std::ostringstream s;
+        s << "elemento-" << valuesA[i];
+        strings.add(s.str());
+    }
+    StringSet reloaded;
+    res["set_save_load"] = measure(strings.getSize(), [&]()
+    {
+        save(strings, "perf_strings.txt");
+        reloaded.empty();
+        load(reloaded, "perf_strings.txt");
+    });
+    check(reloaded == strings, "set_save_load");
+    std::remove("perf_strings.txt");
+
+    CompressedSet compReloaded;
+    res["compressed_save_load"] = measure(FAST_N, [&]()
+    {
+        save(compA, "perf_compressed.bin");
+        load(compReloaded, "perf_compressed.bin");
+    });
+    check(compReloaded == compA, "compressed_save_load");
+    std::remove("perf_compressed.bin");
+
+    gSink = gSink + hits + unionSize + interSize;
+    return res;
+}
+
+static std::map<std::string, double> readBaseline(const std::string& path)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        std::string name;
+        double value;
+        if(fields >> name >> value)
+            baseline[name] = value;
+    }
+    return baseline;
+}
+
+static void writeBaseline(const std::string& path, const std::map<std::string, double>& results)
+{
+    std::ofstream file(path);
+    file << "# Throughput di riferimento (operazioni al secondo) di perf_gset.cpp\n";
+    file << "# Rigenerare con: GSetPerf <questo file> --update\n";
+    for(std::map<std::string, double>::const_iterator i = results.begin(); i != results.end(); ++i)
+    {
+        file << i->first << ' ' << static_cast<long long>(i->second) << '\n';
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "Uso: " << argv[0] << " <baseline> [--update] [--tolerance t]" << std::endl;
+        return 2;
+    }
+
+    std::string baselinePath = argv[1];
+    bool update = false;
+    double tolerance = 0.5;
+    if(const char* env = std::getenv("GSET_PERF_TOLERANCE"))
+        tolerance = std::atof(env);
+    for(int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--update")
+            update = true;
+        else if(arg == "--tolerance" && i + 1 < argc)
+            tolerance = std::atof(argv[++i]);
+    }
+
+    std::map<std::string, double> results = runWorkloads();
+
+    if(update)
+    {
+        writeBaseline(baselinePath, results);
+        std::cout << "Riferimento aggiornato: " << baselinePath << std::endl;
+        return gFailed ? 1 : 0;
+    }
+
+    std::map<std::string, double> baseline = readBaseline(baselinePath);
+    std::cout << std::left << std::setw(26) << "carico di lavoro" << std::right << std::setw(14) << "op/s"
+              << std::setw(14) << "riferimento" << std::setw(8) << "%" << std::endl;
+    for(std::map<std::string, double>::const_iterator i = results.begin(); i != results.end(); ++i)
+    {
+        std::cout << std::left << std::setw(26) << i->first << std::right << std::setw(14)
+                  << static_cast<long long>(i->second);
+
+        std::map<std::string, double>::const_iterator ref = baseline.find(i->first);
+        if(ref == baseline.end())
+        {
+            std::cout << std::setw(14) << "-" << "  (nessun riferimento)" << std::endl;
+            continue;
+        }
+
+        double ratio = i->second / ref->second;
+        std::cout << std::setw(14) << static_cast<long long>(ref->second) << std::setw(7)
+                  << static_cast<int>(ratio * 100) << "%";
+        if(ratio < 1 - tolerance)
+        {
+            std::cout << "  REGRESSIONE";
+            gFailed = true;
+        }
+        std::cout << std::endl;
+    }
+
+    return gFailed ? 1 : 0;
+}